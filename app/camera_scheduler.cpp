@@ -0,0 +1,220 @@
+/**
+ * @file camera_scheduler.cpp
+ * @author Tathya Bhatt (tathyab@umd.edu)
+ * @brief Proximity-aware scheduling of several cameras on one model
+ * @version 1.0
+ * @date 2024-11-08
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "../include/camera_scheduler.hpp"
+
+#include <algorithm>
+
+/**
+ * @brief Adds a camera to the schedule
+ * @param config Scheduling settings
+ * @return int Camera id
+ */
+int CameraScheduler::addCamera(const CameraConfig &config) {
+  Camera cam;
+  cam.config = config;
+  cameras.push_back(cam);
+  return static_cast<int>(cameras.size()) - 1;
+}
+
+/**
+ * @brief Removes a camera from scheduling
+ * @param id Camera id
+ */
+void CameraScheduler::disable(int id) { cameras[id].enabled = false; }
+
+/**
+ * @brief Checks whether a camera is in its hot state
+ * @param id Camera id
+ * @param now_ms Current time in milliseconds
+ * @return bool True if a warning was raised within the hold time
+ */
+bool CameraScheduler::isHot(int id, double now_ms) const {
+  const Camera &cam = cameras[id];
+  return cam.warned &&
+         now_ms - cam.last_warning_ms <= cam.config.hot_hold_ms;
+}
+
+/**
+ * @brief Time at which a camera is next due
+ *
+ * A camera that has never been served is due immediately.
+ *
+ * @param id Camera id
+ * @param now_ms Current time
+ * @return double Due time in milliseconds
+ */
+double CameraScheduler::dueTime(int id, double now_ms) const {
+  const Camera &cam = cameras[id];
+  if (!cam.served) {
+    return now_ms;
+  }
+  double interval = isHot(id, now_ms) ? cam.config.hot_interval_ms
+                                      : cam.config.quiet_interval_ms;
+  double due = cam.last_served_ms + interval;
+  return std::min(due, cam.last_served_ms + cam.config.starvation_ms);
+}
+
+/**
+ * @brief Picks the camera to serve next
+ *
+ * Starving cameras come first, longest wait first. Next come urgent
+ * cameras, whose deadline (due time plus SLO) has passed or would pass while
+ * waiting behind another frame: urgent hot cameras before urgent quiet ones,
+ * earliest deadline first within each. Otherwise the due camera with the
+ * highest score wins, where the score is how many intervals it is overdue,
+ * boosted for hot cameras.
+ *
+ * @param now_ms Current time in milliseconds
+ * @return int Camera id, or -1 if no camera is due
+ */
+int CameraScheduler::pickNext(double now_ms) const {
+  int best = -1;
+  double best_score = 0.0;
+  for (std::size_t i = 0; i < cameras.size(); i++) {
+    const Camera &cam = cameras[i];
+    double due = dueTime(static_cast<int>(i), now_ms);
+    if (!cam.enabled || due > now_ms) {
+      continue;
+    }
+
+    double score = 0.0;
+    if (!cam.served) {
+      score = 1e9;  // Every camera gets one frame before anything else
+    } else {
+      double waited = now_ms - cam.last_served_ms;
+      bool hot = isHot(static_cast<int>(i), now_ms);
+      // Time left after this camera's own frame before its SLO runs out
+      double slack = due + cam.config.slo_ms - now_ms - cam.est_cost_ms;
+      if (waited >= cam.config.starvation_ms) {
+        score = 1e6 + waited;
+      } else if (slack <= cam.est_cost_ms) {
+        // Urgent: late already, or late after one more frame. Hot cameras
+        // have their own tier above quiet ones, so a quiet deadline never
+        // goes ahead of an urgent hot camera. Slack is bounded by the
+        // starvation limit, the clamp only keeps the tiers apart.
+        score = (hot ? 3e5 : 1e5) - std::max(slack, -9e4);
+      } else {
+        double interval = hot ? cam.config.hot_interval_ms
+                              : cam.config.quiet_interval_ms;
+        score = waited / std::max(interval, 1.0);
+        if (hot) {
+          score *= hot_weight;
+        }
+      }
+    }
+
+    if (best < 0 || score > best_score) {
+      best = static_cast<int>(i);
+      best_score = score;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Time until the next camera becomes due
+ * @param now_ms Current time in milliseconds
+ * @return double Milliseconds to wait, 0 if a camera is due, negative if no
+ * camera is enabled
+ */
+double CameraScheduler::nextDueIn(double now_ms) const {
+  double wait = -1.0;
+  for (std::size_t i = 0; i < cameras.size(); i++) {
+    if (!cameras[i].enabled) {
+      continue;
+    }
+    double in =
+        std::max(0.0, dueTime(static_cast<int>(i), now_ms) - now_ms);
+    if (wait < 0.0 || in < wait) {
+      wait = in;
+    }
+  }
+  return wait;
+}
+
+/**
+ * @brief Records that a camera was served
+ *
+ * The latency is measured from the time the camera became due, so time spent
+ * waiting behind other cameras counts against the SLO.
+ *
+ * @param id Camera id
+ * @param start_ms Time the frame was picked
+ * @param end_ms Time the result was ready
+ * @param warning True if a human was inside the warning distance
+ */
+void CameraScheduler::report(int id, double start_ms, double end_ms,
+                             bool warning) {
+  Camera &cam = cameras[id];
+  double due = dueTime(id, start_ms);
+  if (cam.served && start_ms - cam.last_served_ms >= cam.config.starvation_ms) {
+    cam.stats.starved++;
+  }
+  double latency = end_ms - std::min(due, start_ms);
+
+  cam.stats.frames++;
+  cam.stats.total_latency_ms += latency;
+  cam.stats.max_latency_ms = std::max(cam.stats.max_latency_ms, latency);
+  if (latency > cam.config.slo_ms) {
+    cam.stats.slo_misses++;
+  }
+
+  // Smoothed frame cost, used to see an SLO miss coming in pickNext()
+  double cost = end_ms - start_ms;
+  cam.est_cost_ms = cam.served ? cam.est_cost_ms +
+                                     cost_smoothing * (cost - cam.est_cost_ms)
+                               : cost;
+
+  cam.served = true;
+  cam.last_served_ms = start_ms;
+  if (warning) {
+    cam.warned = true;
+    cam.last_warning_ms = end_ms;
+  }
+}
+
+/**
+ * @brief Counters for a camera
+ * @param id Camera id
+ * @return const CameraStats& Camera counters
+ */
+const CameraStats &CameraScheduler::stats(int id) const {
+  return cameras[id].stats;
+}
+
+/**
+ * @brief Settings of a camera
+ * @param id Camera id
+ * @return const CameraConfig& Camera settings
+ */
+const CameraConfig &CameraScheduler::config(int id) const {
+  return cameras[id].config;
+}
+
+/**
+ * @brief Number of cameras added
+ * @return std::size_t Camera count
+ */
+std::size_t CameraScheduler::size() const { return cameras.size(); }
+
+/**
+ * @brief Number of cameras still enabled
+ * @return std::size_t Camera count
+ */
+std::size_t CameraScheduler::enabledCount() const {
+  std::size_t count = 0;
+  for (const Camera &cam : cameras) {
+    if (cam.enabled) {
+      count++;
+    }
+  }
+  return count;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file frame_arena.cpp
+ * @author Tathya Bhatt (tathyab@umd.edu)
+ * @brief Recycled per-frame buffers for the detection loop
+ * @version 1.0
+ * @date 2024-11-06
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "../include/frame_arena.hpp"
+
+AllocationCounter FrameArena::counter = nullptr;
+
+/**
+ * @brief Constructor that reserves room for the candidate lists
+ *
+ * Every row of the YOLO output can become a candidate, so reserving the row
+ * count up front keeps the lists from growing on a crowded frame.
+ *
+ * @param max_candidates Expected maximum number of candidate boxes
+ */
+FrameArena::FrameArena(std::size_t max_candidates) {
+  boxes.reserve(max_candidates);
+  class_ids.reserve(max_candidates);
+  class_confidences.reserve(max_candidates);
+  indices.reserve(max_candidates);
+  order.reserve(max_candidates);
+}
+
+/**
+ * @brief Installs the source of the process-wide allocation count
+ *
+ * The count is process-wide, so allocations made by other threads during a
+ * frame are included as well.
+ *
+ * @param allocation_counter Counter function, nullptr to count only the
+ * arena's own buffers
+ */
+void FrameArena::setAllocationCounter(AllocationCounter allocation_counter) {
+  counter = allocation_counter;
+}
+
+/**
+ * @brief Checks whether every heap allocation is counted, or only the
+ * arena's own buffers
+ * @return bool True if an allocation counter is installed
+ */
+bool FrameArena::countsAllAllocations() { return counter != nullptr; }
+
+/**
+ * @brief Collects the current state of every buffer in the arena
+ *
+ * A buffer that was allocated or resized has a new address or size. A buffer
+ * freed and allocated again at the same address and size is not seen, which
+ * is why an allocation counter is preferred when one is installed.
+ *
+ * @param states Output list of buffer states
+ */
+void FrameArena::collect(std::vector<BufferState> &states) {
+  states.clear();
+  states.push_back({blob_img.data, blob_img.total() * blob_img.elemSize()});
+  states.push_back({boxed_img.data, boxed_img.total() * boxed_img.elemSize()});
+  states.push_back({out_imgs.data(), out_imgs.capacity()});
+  states.push_back({boxes.data(), boxes.capacity()});
+  states.push_back({class_ids.data(), class_ids.capacity()});
+  states.push_back({class_confidences.data(), class_confidences.capacity()});
+  states.push_back({indices.data(), indices.capacity()});
+  states.push_back({order.data(), order.capacity()});
+  states.push_back({out_names.data(), out_names.capacity()});
+  states.push_back({layer_times.data(), layer_times.capacity()});
+  states.push_back({resize_x.data(), resize_x.capacity()});
+  states.push_back({weight_x.data(), weight_x.capacity()});
+  states.push_back({resize_y.data(), resize_y.capacity()});
+  states.push_back({weight_y.data(), weight_y.capacity()});
+  for (const cv::Mat &out : out_imgs) {
+    states.push_back({out.data, out.total() * out.elemSize()});
+  }
+}
+
+/**
+ * @brief Clears the per-frame lists, keeping their memory
+ */
+void FrameArena::beginFrame() {
+  boxes.clear();
+  class_ids.clear();
+  class_confidences.clear();
+  indices.clear();
+  order.clear();
+  if (counter != nullptr) {
+    start_count = counter();
+    return;
+  }
+  // Leave room for the network outputs so the snapshot never reallocates
+  snapshot.reserve(14 + out_imgs.size() + 4);
+  collect(snapshot);
+}
+
+/**
+ * @brief Counts the allocations made since beginFrame()
+ * @return std::size_t Number of allocations made in this frame
+ */
+std::size_t FrameArena::endFrame() {
+  std::size_t count = 0;
+  if (counter != nullptr) {
+    count = counter() - start_count;
+  } else {
+    std::size_t before = snapshot.size();
+    std::size_t i = 0;
+    // Compare in place so the check itself does not allocate
+    auto check = [&](const void *data, std::size_t bytes) {
+      if (data != nullptr && (i >= before || snapshot[i].data != data ||
+                              snapshot[i].bytes != bytes)) {
+        count++;
+      }
+      i++;
+    };
+    check(blob_img.data, blob_img.total() * blob_img.elemSize());
+    check(boxed_img.data, boxed_img.total() * boxed_img.elemSize());
+    check(out_imgs.data(), out_imgs.capacity());
+    check(boxes.data(), boxes.capacity());
+    check(class_ids.data(), class_ids.capacity());
+    check(class_confidences.data(), class_confidences.capacity());
+    check(indices.data(), indices.capacity());
+    check(order.data(), order.capacity());
+    check(out_names.data(), out_names.capacity());
+    check(layer_times.data(), layer_times.capacity());
+    check(resize_x.data(), resize_x.capacity());
+    check(weight_x.data(), weight_x.capacity());
+    check(resize_y.data(), resize_y.capacity());
+    check(weight_y.data(), weight_y.capacity());
+    for (const cv::Mat &out : out_imgs) {
+      check(out.data, out.total() * out.elemSize());
+    }
+  }
+
+  last_allocations = count;
+  total_allocations += count;
+  frame_count++;
+  return count;
+}
+
+/**
+ * @brief Number of allocations made in the last finished frame
+ * @return std::size_t Allocation count
+ */
+std::size_t FrameArena::lastFrameAllocations() { return last_allocations; }
+
+/**
+ * @brief Number of allocations made since the arena was created
+ * @return std::size_t Allocation count
+ */
+std::size_t FrameArena::totalAllocations() { return total_allocations; }
+
+/**
+ * @brief Number of frames finished with endFrame()
+ * @return std::size_t Frame count
+ */
+std::size_t FrameArena::frames() { return frame_count; }
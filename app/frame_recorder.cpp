@@ -0,0 +1,325 @@
+/**
+ * @file frame_recorder.cpp
+ * @author Tathya Bhatt (tathyab@umd.edu)
+ * @brief Background recording of the annotated detection output
+ * @version 1.0
+ * @date 2024-11-05
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "../include/frame_recorder.hpp"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <iostream>
+
+/**
+ * @brief Constructor for the recorder
+ *
+ * Nothing is allocated until start() is called with the frame size.
+ *
+ * @param cfg Recording settings
+ */
+FrameRecorder::FrameRecorder(const RecorderConfig &cfg) : config(cfg) {}
+
+/**
+ * @brief Destructor
+ *
+ * Flushes any queued frames and joins the writer thread.
+ */
+FrameRecorder::~FrameRecorder() { stop(); }
+
+/**
+ * @brief Allocates the buffer pool and starts the writer thread
+ *
+ * All buffers are allocated here once so that push() only copies pixels.
+ *
+ * @param size Size of the frames that will be pushed
+ * @return bool True if the recorder started
+ */
+bool FrameRecorder::start(const cv::Size &size) {
+  std::lock_guard<std::mutex> lock(mtx);
+  if (running) {
+    return true;
+  }
+  if (size.width <= 0 || size.height <= 0) {
+    std::cout << "Error, invalid frame size for recording" << std::endl;
+    return false;
+  }
+
+  // The pool has to hold the whole pre-roll plus a few frames in flight
+  std::size_t slots = config.pool_size;
+  if (config.event_triggered) {
+    slots = std::max(slots, config.pre_event_frames + 8);
+  }
+  slots = std::max<std::size_t>(slots, 1);
+
+  frame_size = size;
+  pool.clear();
+  free_slots.clear();
+  pending.clear();
+  pre_roll.clear();
+  post_event_left = 0;
+  for (std::size_t i = 0; i < slots; i++) {
+    pool.push_back(cv::Mat(frame_size, CV_8UC3));
+    free_slots.push_back(i);
+  }
+
+  segment_frames = 0;
+  running = true;
+  writer_thread = std::thread(&FrameRecorder::writerLoop, this);
+  std::cout << "Recording started with " << slots << " buffers" << std::endl;
+  return true;
+}
+
+/**
+ * @brief Takes a buffer from the pool
+ *
+ * In event-triggered mode the oldest pre-roll frame is recycled when the pool
+ * is empty, so a long quiet period never starves the recorder. The caller must
+ * hold the lock.
+ *
+ * @param slot Index of the acquired buffer
+ * @return bool False if no buffer is available
+ */
+bool FrameRecorder::acquireSlot(std::size_t &slot) {
+  if (!free_slots.empty()) {
+    slot = free_slots.front();
+    free_slots.pop_front();
+    return true;
+  }
+  if (config.event_triggered && !pre_roll.empty()) {
+    slot = pre_roll.front();
+    pre_roll.pop_front();
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Queues an annotated frame for writing without blocking
+ *
+ * The only work done on the calling thread is one pixel copy into a recycled
+ * buffer. If the writer has fallen behind and no buffer is free, the frame is
+ * dropped and counted.
+ *
+ * @param frame Annotated frame, must match the size given to start()
+ * @param warning True if a human is inside the warning distance
+ * @return bool False if the frame was dropped
+ */
+bool FrameRecorder::push(const cv::Mat &frame, bool warning) {
+  std::size_t slot = 0;
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!running) {
+      return false;
+    }
+    pushed_count++;
+    if (frame.size() != frame_size || frame.type() != CV_8UC3 ||
+        !acquireSlot(slot)) {
+      dropped_count++;
+      return false;
+    }
+  }
+
+  // Same size and type, so this copies into the existing buffer
+  frame.copyTo(pool[slot]);
+
+  std::lock_guard<std::mutex> lock(mtx);
+  if (!config.event_triggered) {
+    pending.push_back(slot);
+  } else if (warning) {
+    // Flush the frames leading up to the event, then this one
+    while (!pre_roll.empty()) {
+      pending.push_back(pre_roll.front());
+      pre_roll.pop_front();
+    }
+    pending.push_back(slot);
+    post_event_left = config.post_event_frames;
+  } else if (post_event_left > 0) {
+    pending.push_back(slot);
+    post_event_left--;
+  } else {
+    pre_roll.push_back(slot);
+    while (pre_roll.size() > config.pre_event_frames) {
+      free_slots.push_back(pre_roll.front());
+      pre_roll.pop_front();
+    }
+    return true;
+  }
+  cv_pending.notify_one();
+  return true;
+}
+
+/**
+ * @brief Opens the next output segment file
+ *
+ * A failed open is not retried for open_retry_seconds, and only the first
+ * failure in a row is logged, so a missing directory or full disk does not
+ * turn into an open attempt and a log line per frame. The segment number is
+ * only used up by a successful open.
+ *
+ * @return bool True if the writer could be opened
+ */
+bool FrameRecorder::openSegment() {
+  writer.release();
+  std::size_t index = 0;
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    index = segment_count;
+  }
+  segment_path = config.output_prefix + cv::format("_%03d.avi",
+                                                   static_cast<int>(index));
+  segment_frames = 0;
+  segment_start_ticks = static_cast<double>(cv::getTickCount());
+  if (!writer.open(segment_path, config.fourcc, config.fps, frame_size,
+                   true)) {
+    if (!open_failed) {
+      std::cout << "Error opening recording file " << segment_path
+                << ", dropping frames and retrying every "
+                << config.open_retry_seconds << " s" << std::endl;
+    }
+    open_failed = true;
+    retry_ticks = segment_start_ticks +
+                  config.open_retry_seconds * cv::getTickFrequency();
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    segment_count++;
+  }
+  open_failed = false;
+  std::cout << "Recording to: " << segment_path << std::endl;
+  return true;
+}
+
+/**
+ * @brief Checks whether the current segment has reached its size or time limit
+ * @return bool True if a new segment should be started
+ */
+bool FrameRecorder::segmentFull() {
+  if (segment_frames == 0) {
+    return false;
+  }
+  if (config.max_segment_seconds > 0.0) {
+    double elapsed = (cv::getTickCount() - segment_start_ticks) /
+                     cv::getTickFrequency();
+    if (elapsed >= config.max_segment_seconds) {
+      return true;
+    }
+  }
+  if (config.max_segment_bytes > 0) {
+    struct stat info;
+    if (stat(segment_path.c_str(), &info) == 0 &&
+        static_cast<std::size_t>(info.st_size) >= config.max_segment_bytes) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Body of the background encoding thread
+ *
+ * Encodes queued buffers in order and returns them to the pool. On stop() the
+ * remaining queue is drained before the writer is released.
+ */
+void FrameRecorder::writerLoop() {
+  std::unique_lock<std::mutex> lock(mtx);
+  while (true) {
+    cv_pending.wait(lock, [this] { return !pending.empty() || !running; });
+    if (pending.empty()) {
+      break;
+    }
+    std::size_t slot = pending.front();
+    pending.pop_front();
+    lock.unlock();
+
+    bool written = false;
+    bool backing_off = open_failed && cv::getTickCount() < retry_ticks;
+    if (!backing_off && (!writer.isOpened() || segmentFull())) {
+      openSegment();
+    }
+    if (writer.isOpened()) {
+      writer.write(pool[slot]);
+      segment_frames++;
+      written = true;
+    }
+
+    lock.lock();
+    free_slots.push_back(slot);
+    if (written) {
+      written_count++;
+    } else {
+      dropped_count++;
+    }
+  }
+  lock.unlock();
+  writer.release();
+}
+
+/**
+ * @brief Flushes queued frames and stops the writer thread
+ */
+void FrameRecorder::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!running) {
+      return;
+    }
+    running = false;
+  }
+  cv_pending.notify_one();
+  if (writer_thread.joinable()) {
+    writer_thread.join();
+  }
+  std::cout << "Recording stopped, written: " << writtenFrames()
+            << " dropped: " << droppedFrames() << std::endl;
+}
+
+/**
+ * @brief Checks whether the writer thread is running
+ * @return bool True if recording
+ */
+bool FrameRecorder::isRunning() {
+  std::lock_guard<std::mutex> lock(mtx);
+  return running;
+}
+
+/**
+ * @brief Number of frames passed to push()
+ * @return std::size_t Frame count
+ */
+std::size_t FrameRecorder::pushedFrames() {
+  std::lock_guard<std::mutex> lock(mtx);
+  return pushed_count;
+}
+
+/**
+ * @brief Number of frames dropped because the pool was exhausted
+ * @return std::size_t Frame count
+ */
+std::size_t FrameRecorder::droppedFrames() {
+  std::lock_guard<std::mutex> lock(mtx);
+  return dropped_count;
+}
+
+/**
+ * @brief Number of frames written to disk
+ * @return std::size_t Frame count
+ */
+std::size_t FrameRecorder::writtenFrames() {
+  std::lock_guard<std::mutex> lock(mtx);
+  return written_count;
+}
+
+/**
+ * @brief Number of segment files opened so far
+ * @return std::size_t Segment count
+ */
+std::size_t FrameRecorder::segments() {
+  std::lock_guard<std::mutex> lock(mtx);
+  return segment_count;
+}
@@ -34,7 +34,14 @@ float HumanAvoidance::calculate_distance(int box_h, int frame_h) {
 // Transforms detected human coordinates to robot coordinate system
 std::vector<float> HumanAvoidance::camera2robot(float z, cv::Rect box,
                                                 cv::Mat frame) {
-  std::vector<double> pos;
+  float coords[3];
+  camera2robot(z, box, frame, coords);
+  return std::vector<float>(coords, coords + 3);
+}
+
+// Same transform written into a fixed array, no heap allocation
+void HumanAvoidance::camera2robot(float z, const cv::Rect &box,
+                                  const cv::Mat &frame, float out[3]) {
   int sensor_w = 24;  // Assumed sensor width in mm
   int sensor_h = 35;  // Assumed sensor height in mm
   double x =
@@ -42,28 +49,22 @@ std::vector<float> HumanAvoidance::camera2robot(float z, cv::Rect box,
   double y =
       (sensor_h * ((box.y + box.height / 2) - (frame.rows / 2))) / frame.cols;
 
-  pos.push_back(x);
-  pos.push_back(y);
-  pos.push_back(z);
-  pos.push_back(1.0);
-
-  std::vector<std::vector<double>> T = {
+  const double pos[4] = {x, y, z, 1.0};
+  const double T[4][4] = {
       {1, 0, 0, 1}, {0, 1, 0, 1}, {0, 0, 1, -2}, {0, 0, 0, 1}};
 
-  std::vector<float> out;
   double res = 0.0;
   for (int i = 0; i < 3; i++) {
     res = 0;
     for (int j = 0; j < 4; j++) {
       res += T[i][j] * pos[j];
     }
-    out.push_back(static_cast<float>(res));
+    out[i] = static_cast<float>(res);
   }
 
   // Output transformed coordinates (x, y, z) for debugging
   std::cout << "Transformed Coordinates: X=" << out[0] << " Y=" << out[1]
             << " Z=" << out[2] << std::endl;
-  return out;
 }
 
 // Destructor
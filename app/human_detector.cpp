@@ -11,15 +11,24 @@
 
 #include "../include/human_detector.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <ostream>
+#include <thread>
 
 #include <opencv4/opencv2/imgcodecs.hpp>
+#include "../include/camera_scheduler.hpp"
 #include "../include/human_avoidance.hpp"
 
 HumanAvoidance avoider;
 
+volatile std::sig_atomic_t HumanDetector::stop_requested = 0;
+
 /**
  * @brief Constructor with default initialization
  *
@@ -74,6 +83,12 @@ cv::Mat HumanDetector::ImgProcessor(cv::VideoCapture &capture_frame) {
 
 /**
  * @brief Draw bounding box around detected human
+ *
+ * The box is drawn right away, the label is queued on the label renderer.
+ * Like rmOverlap, the caller decides when the queue is drawn, with
+ * renderLabels(), so anything already queued for another frame is not
+ * flushed onto this one.
+ *
  * @param classid ID of the detected class
  * @param confidence Confidence score of the detection
  * @param left Left coordinate of the bounding box
@@ -94,32 +109,80 @@ void HumanDetector::drawBbox(int classid, float confidence, int left, int top,
                       "  Confidence:" + cv::format("%.2f", confidence) +
                       "  ID:" + std::to_string(uniq_id);
   int baseLine;
-  cv::Size labelSize =
-      cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX, 0.5, 1, &baseLine);
+  cv::Size labelSize = renderer.measure(label, &baseLine);
   top = std::max(top, labelSize.height);
-  cv::rectangle(frame, cv::Point(left, top - labelSize.height),
-                cv::Point(left + labelSize.width, top + baseLine),
-                cv::Scalar(0, 255, 0), cv::FILLED);
-  cv::putText(frame, label, cv::Point(left, top), cv::FONT_HERSHEY_SIMPLEX, 0.5,
-              cv::Scalar(0, 0, 0), 1);
+  renderer.addRect(cv::Point(left, top - labelSize.height),
+                   cv::Point(left + labelSize.width, top + baseLine),
+                   cv::Scalar(0, 255, 0), cv::FILLED);
+  renderer.addText(label, cv::Point(left, top), cv::Scalar(0, 0, 0));
 }
 
+/**
+ * @brief Draw the queued labels onto a frame and clear the queue
+ * @param frame Reference to the frame to draw on
+ */
+void HumanDetector::renderLabels(cv::Mat &frame) { renderer.render(frame); }
+
+/**
+ * @brief Attach a recorder that receives every annotated frame
+ *
+ * The recorder is started lazily with the size of the first annotated frame.
+ *
+ * @param rec Pointer to the recorder, nullptr to disable recording
+ */
+void HumanDetector::setRecorder(FrameRecorder *rec) { recorder = rec; }
+
+/**
+ * @brief Asks every detection loop to finish
+ *
+ * Only sets a flag, so it is safe to call from a signal handler. The loops
+ * return after the current frame and the caller can then shut down cleanly,
+ * e.g. finalize the recording.
+ */
+void HumanDetector::requestStop() { stop_requested = 1; }
+
+/**
+ * @brief Checks whether the detection loops were asked to finish
+ * @return bool True after requestStop()
+ */
+bool HumanDetector::stopRequested() { return stop_requested != 0; }
+
+/**
+ * @brief Access the recycled per-frame buffers
+ * @return FrameArena& Reference to the detector's arena
+ */
+FrameArena &HumanDetector::frameArena() { return arena; }
+
+/**
+ * @brief Check whether the last processed frame raised a warning
+ * @return bool True if a human was inside the warning distance
+ */
+bool HumanDetector::warningActive() { return human_warning; }
+
 /**
  * @brief Removes overlapped boxes based on NMS
  * @param input_frame Reference to the input frame
  * @param img Size of the image
  * @param out_imgs Vector of output images from YOLO
  * @param classes Lists of class names
- * @return cv::Mat Processed image with non-overlapping bounding boxes
+ * @return cv::Mat Processed image with non-overlapping bounding boxes. The
+ * image is backed by the frame arena and is overwritten by the next call.
  */
 cv::Mat HumanDetector::rmOverlap(cv::Mat &input_frame, cv::Size &img,
                                  std::vector<cv::Mat> &out_imgs,
                                  std::vector<std::string> &classes) {
-  std::vector<int> class_ids;
-  std::vector<float> class_confidences;
-  std::vector<cv::Rect> boxes;
-
-  cv::Mat boxed_img = input_frame.clone();
+  // Candidate lists and the output frame are recycled from the arena
+  std::vector<int> &class_ids = arena.class_ids;
+  std::vector<float> &class_confidences = arena.class_confidences;
+  std::vector<cv::Rect> &boxes = arena.boxes;
+  class_ids.clear();
+  class_confidences.clear();
+  boxes.clear();
+
+  // Same size and type as last frame, so this reuses the existing buffer
+  input_frame.copyTo(arena.boxed_img);
+  cv::Mat boxed_img = arena.boxed_img;
+  human_warning = false;
 
   float x_factor =
       static_cast<float>(img.width) / static_cast<float>(yolo_width);
@@ -136,16 +199,13 @@ cv::Mat HumanDetector::rmOverlap(cv::Mat &input_frame, cv::Size &img,
     float confidence = info[4];
 
     if (confidence > confidenceThresh) {
-      float classes_scores = info[5];
+      // Only the person score (class 0) is used, so other classes never
+      // get a box, a distance or a warning
+      float person_score = info[5];
 
-      cv::Mat scores(1, classes.size(), CV_32FC1, classes_scores);
-      cv::Point class_id;
-      double max_prob_class;
-      cv::minMaxLoc(scores, 0, &max_prob_class, 0, &class_id);
-
-      if (max_prob_class > score_threshold) {
+      if (person_score > score_threshold) {
         class_confidences.push_back(confidence);
-        class_ids.push_back(class_id.x);
+        class_ids.push_back(0);
 
         float centerX = info[0];
         float centerY = info[1];
@@ -164,10 +224,10 @@ cv::Mat HumanDetector::rmOverlap(cv::Mat &input_frame, cv::Size &img,
   }
 
   // Apply NMS
-  std::vector<int> indices;
-  cv::dnn::NMSBoxes(boxes, class_confidences, score_threshold, nmsthresh,
-                    indices);
+  suppressOverlaps();
+  std::vector<int> &indices = arena.indices;
 
+  // All boxes and labels are queued and drawn in a single pass below
   for (int i = 0; i < indices.size(); i++) {
     int idx = indices[i];
     cv::Rect box = boxes[idx];
@@ -175,79 +235,303 @@ cv::Mat HumanDetector::rmOverlap(cv::Mat &input_frame, cv::Size &img,
     int top = box.y;
     int width = box.width;
     int height = box.height;
-    cv::rectangle(boxed_img, cv::Point(left, top),
-                  cv::Point(left + width, top + height),
-                  cv::Scalar(255, 178, 50), 4);
-    std::string label = cv::format("%.2f", class_confidences[idx]);
-    label = classes[class_ids[idx]] + "|" + label;
+    renderer.addRect(cv::Point(left, top),
+                     cv::Point(left + width, top + height),
+                     cv::Scalar(255, 178, 50), 4);
+    // Labels are formatted into stack buffers, no per-frame strings
+    char label[64];
+    std::snprintf(label, sizeof(label), "%s|%.2f",
+                  classes[class_ids[idx]].c_str(), class_confidences[idx]);
 
     int baseLine;
-    cv::Size label_size =
-        getTextSize(label, cv::FONT_HERSHEY_SIMPLEX, 0.5, 1, &baseLine);
+    cv::Size label_size = renderer.measure(label, &baseLine);
     cv::Point top_left = cv::Point(left, top);
     cv::Point bottom_right =
         cv::Point(left + label_size.width, top + label_size.height + baseLine);
 
     // ______________________________________________________________________________________________________________________________________________
-    std::vector<float> robot_coord =
-        avoider.camera2robot(box.height, box, boxed_img);
+    float robot_coord[3];
+    avoider.camera2robot(box.height, box, boxed_img, robot_coord);
 
-    std::string coordinates_label =
-        "X = " + cv::format("%.2f", robot_coord[0]) +
-        " Y = " + cv::format("%.2f", robot_coord[1]) +
-        " Z = " + cv::format("%.2f", robot_coord[2]);
+    char coordinates_label[96];
+    std::snprintf(coordinates_label, sizeof(coordinates_label),
+                  "X = %.2f Y = %.2f Z = %.2f", robot_coord[0],
+                  robot_coord[1], robot_coord[2]);
 
     cv::Point c_left = cv::Point(left + label_size.width + 105, top);
     cv::Point c_right = cv::Point(left + label_size.width + 375,
                                   top + label_size.height + baseLine);
 
     // Draw black rectangle for label background
-    cv::rectangle(boxed_img, c_left, c_right, cv::Scalar(0, 0, 0), cv::FILLED);
+    renderer.addRect(c_left, c_right, cv::Scalar(0, 0, 0), cv::FILLED);
     // Put the label on the rectangle
-    cv::putText(
-        boxed_img, coordinates_label,
+    renderer.addText(
+        coordinates_label,
         cv::Point(left + label_size.width + 105, top + label_size.height),
-        cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 255, 255), 1);
+        cv::Scalar(0, 255, 255));
     // ______________________________________________________________________________________________________________________________________________
 
     // --------------------------------------------------------------------------------------------------------------------------------
     double dist2human = avoider.calculate_distance(box.height, img.height);
-    std::string dist_label = "D2H = " + cv::format("%.2f", dist2human);
+    char dist_label[32];
+    std::snprintf(dist_label, sizeof(dist_label), "D2H = %.2f", dist2human);
     cv::Point t_left = cv::Point(left + label_size.width + 5, top);
     cv::Point b_right = cv::Point(left + label_size.width + 100,
                                   top + label_size.height + baseLine);
-    // Draw black rectangle for label background
-    if (dist2human < 1.5) {
-      cv::rectangle(boxed_img, t_left, b_right, cv::Scalar(0, 0, 255),
-                    cv::FILLED);
-      // Put the label on the rectangle
-      cv::putText(
-          boxed_img, dist_label,
-          cv::Point(left + label_size.width + 1, top + label_size.height),
-          cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(255, 255, 255), 1);
+    cv::Point dist_origin =
+        cv::Point(left + label_size.width + 1, top + label_size.height);
+    // Red background with white text inside the warning distance
+    if (dist2human < warning_dist) {
+      human_warning = true;
+      renderer.addRect(t_left, b_right, cv::Scalar(0, 0, 255), cv::FILLED);
+      renderer.addText(dist_label, dist_origin, cv::Scalar(255, 255, 255));
     } else {
-      cv::rectangle(boxed_img, t_left, b_right, cv::Scalar(0, 0, 0),
-                    cv::FILLED);
-      // Put the label on the rectangle
-      cv::putText(
-          boxed_img, dist_label,
-          cv::Point(left + label_size.width + 1, top + label_size.height),
-          cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 255, 255), 1);
+      renderer.addRect(t_left, b_right, cv::Scalar(0, 0, 0), cv::FILLED);
+      renderer.addText(dist_label, dist_origin, cv::Scalar(0, 255, 255));
     }
 
     // --------------------------------------------------------------------------------------------------------------------------------
 
     // Draw black rectangle for label background
-    cv::rectangle(boxed_img, top_left, bottom_right, cv::Scalar(0, 0, 0),
-                  cv::FILLED);
+    renderer.addRect(top_left, bottom_right, cv::Scalar(0, 0, 0), cv::FILLED);
     // Put the label on the rectangle
-    cv::putText(boxed_img, label, cv::Point(left, top + label_size.height),
-                cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 255, 255), 1);
+    renderer.addText(label, cv::Point(left, top + label_size.height),
+                     cv::Scalar(0, 255, 255));
   }
 
+  renderer.render(boxed_img);
   return boxed_img;
 }
 
+/**
+ * @brief Greedy non-maximum suppression over the arena's candidates
+ *
+ * Same rule as cv::dnn::NMSBoxes: candidates above the score threshold are
+ * visited from the highest score down, ties in input order, and a candidate
+ * is kept unless it overlaps a kept box by more than the NMS threshold. The
+ * sort runs in place on the arena's scratch list, so unlike NMSBoxes this
+ * does not allocate per frame.
+ */
+void HumanDetector::suppressOverlaps() {
+  const std::vector<cv::Rect> &boxes = arena.boxes;
+  const std::vector<float> &scores = arena.class_confidences;
+  std::vector<int> &order = arena.order;
+  std::vector<int> &indices = arena.indices;
+  order.clear();
+  indices.clear();
+
+  for (int i = 0; i < static_cast<int>(scores.size()); i++) {
+    if (scores[i] > score_threshold) {
+      order.push_back(i);
+    }
+  }
+  std::sort(order.begin(), order.end(), [&scores](int a, int b) {
+    return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+  });
+
+  for (int idx : order) {
+    const cv::Rect &box = boxes[idx];
+    bool keep = true;
+    for (int kept : indices) {
+      const cv::Rect &other = boxes[kept];
+      double inter = (box & other).area();
+      double uni = box.area() + other.area() - inter;
+      double overlap = uni > 0 ? inter / uni : 1.0;
+      if (overlap > nmsthresh) {
+        keep = false;
+        break;
+      }
+    }
+    if (keep) {
+      indices.push_back(idx);
+    }
+  }
+}
+
+/**
+ * @brief Loads the class names and the YOLO model
+ *
+ * @param is_test_mode True to load from the paths used by the unit tests
+ * @param classes Output list of class names
+ * @return cv::dnn::Net Loaded model
+ */
+cv::dnn::Net HumanDetector::loadModel(bool is_test_mode,
+                                      std::vector<std::string> &classes) {
+  std::string class_path;
+  std::string model_path;
+
+  // Assign values based on whether we're in test mode or not
+  if (is_test_mode) {
+    class_path = "../../models/coco.names";
+    model_path = "../../models/yolov5s.onnx";
+  } else {
+    class_path = "./models/coco.names";  // Normal mode paths
+    model_path = "./models/yolov5s.onnx";
+  }
+
+  // Read class names from the file
+  std::ifstream read_input(class_path);
+  classes.clear();
+  std::string text;
+  while (read_input >> text) {
+    getline(read_input, text);
+    classes.push_back(text);
+  }
+
+  return cv::dnn::readNet(model_path);
+}
+
+namespace {
+
+/**
+ * @brief Source index and interpolation weight for each output index
+ *
+ * Uses the pixel-center mapping of cv::resize with INTER_LINEAR, clamped at
+ * the borders.
+ *
+ * @param src Source length
+ * @param dst Output length
+ * @param index Output source index per output index
+ * @param weight Output weight of the next source index
+ */
+void bilinearTable(int src, int dst, std::vector<int> &index,
+                          std::vector<float> &weight) {
+  index.resize(dst);
+  weight.resize(dst);
+  double scale = static_cast<double>(src) / dst;
+  for (int d = 0; d < dst; d++) {
+    double pos = (d + 0.5) * scale - 0.5;
+    int i = static_cast<int>(std::floor(pos));
+    float w = static_cast<float>(pos - i);
+    if (i < 0) {
+      i = 0;
+      w = 0.0f;
+    } else if (i >= src - 1) {
+      i = src - 1;
+      w = 0.0f;
+    }
+    index[d] = i;
+    weight[d] = w;
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief Build the network input blob for a frame
+ *
+ * Equivalent to cv::dnn::blobFromImage with scale 1/255, swapped R and B and
+ * a bilinear resize to the model size, but done in one pass straight into
+ * the arena's NCHW blob. blobFromImage allocates a resized image and a float
+ * copy on every frame, this only allocates the blob and the resize tables
+ * when the frame size changes. Frames that are not 8-bit BGR go through
+ * blobFromImage.
+ *
+ * @param input_img Frame to process
+ * @return cv::Mat& NCHW blob, backed by the frame arena
+ */
+cv::Mat &HumanDetector::prepareBlob(const cv::Mat &input_img) {
+  cv::Mat &blob = arena.blob_img;
+  if (input_img.type() != CV_8UC3 || input_img.empty()) {
+    cv::dnn::blobFromImage(input_img, blob, 1 / 255.0,
+                           cv::Size(yolo_width, yolo_height), cv::Scalar(),
+                           true, false);
+    return blob;
+  }
+
+  const int blob_dims[4] = {1, 3, yolo_height, yolo_width};
+  blob.create(4, blob_dims, CV_32F);
+  if (arena.blob_source != input_img.size()) {
+    bilinearTable(input_img.cols, yolo_width, arena.resize_x, arena.weight_x);
+    bilinearTable(input_img.rows, yolo_height, arena.resize_y, arena.weight_y);
+    arena.blob_source = input_img.size();
+  }
+
+  // Plane c of the blob holds BGR channel 2 - c, i.e. RGB order
+  float *planes[3] = {blob.ptr<float>(0, 0), blob.ptr<float>(0, 1),
+                      blob.ptr<float>(0, 2)};
+  const float scale = 1.0f / 255.0f;
+  for (int y = 0; y < yolo_height; y++) {
+    int y0 = arena.resize_y[y];
+    int y1 = std::min(y0 + 1, input_img.rows - 1);
+    float fy = arena.weight_y[y];
+    const unsigned char *top = input_img.ptr<unsigned char>(y0);
+    const unsigned char *bottom = input_img.ptr<unsigned char>(y1);
+    int row = y * yolo_width;
+    for (int x = 0; x < yolo_width; x++) {
+      int x0 = 3 * arena.resize_x[x];
+      int x1 = 3 * std::min(arena.resize_x[x] + 1, input_img.cols - 1);
+      float fx = arena.weight_x[x];
+      for (int c = 0; c < 3; c++) {
+        float t = top[x0 + c] + fx * (top[x1 + c] - top[x0 + c]);
+        float b = bottom[x0 + c] + fx * (bottom[x1 + c] - bottom[x0 + c]);
+        planes[2 - c][row + x] = (t + fy * (b - t)) * scale;
+      }
+    }
+  }
+  return blob;
+}
+
+/**
+ * @brief Runs the model on one frame and annotates the result
+ *
+ * Shared by every input mode so that one model and one set of arena buffers
+ * can serve several sources.
+ *
+ * @param yolo_model Loaded model
+ * @param input_img Frame to process
+ * @param classes List of class names
+ * @return cv::Mat Annotated frame, backed by the frame arena
+ */
+cv::Mat HumanDetector::processFrame(cv::dnn::Net &yolo_model,
+                                    cv::Mat &input_img,
+                                    std::vector<std::string> &classes) {
+  arena.beginFrame();
+
+  // Prepare the image for the model
+  cv::Mat &blob_img = prepareBlob(input_img);
+
+  // Set the input to the model
+  yolo_model.setInput(blob_img);
+
+  // The output names only depend on the model, look them up once
+  if (arena.out_names.empty()) {
+    arena.out_names = yolo_model.getUnconnectedOutLayersNames();
+  }
+  std::vector<cv::Mat> &out_imgs = arena.out_imgs;
+  yolo_model.forward(out_imgs, arena.out_names);
+
+  // Performance measurement, queued on the overlay layer so rmOverlap draws
+  // it on top in the same pass as the boxes
+  std::vector<double> &layer_time = arena.layer_times;
+  double freq = cv::getTickFrequency() / 1000;
+  double time = yolo_model.getPerfProfile(layer_time) / freq;
+  char label[64];
+  std::snprintf(label, sizeof(label), "Inference time: %.2f ms", time);
+  renderer.addText(label, cv::Point(0, 15), cv::Scalar(0, 0, 255), 1.0, 1);
+
+  cv::Size frame_size = cv::Size(input_img.cols, input_img.rows);
+
+  // Call the method to remove overlaps
+  cv::Mat final_img = rmOverlap(input_img, frame_size, out_imgs, classes);
+  // Without an allocation counter the arena only sees its own buffers, so
+  // this is logged as what it is. It happens on the first frame and when a
+  // crowd outgrows the reserved lists, not every frame.
+  std::size_t allocations = arena.endFrame();
+  if (!FrameArena::countsAllAllocations() && allocations > 0) {
+    std::cout << "Arena buffers reallocated: " << allocations << std::endl;
+  }
+
+  // Hand the annotated frame to the recorder, never blocks
+  if (recorder != nullptr) {
+    if (!recorder->isRunning()) {
+      recorder->start(final_img.size());
+    }
+    recorder->push(final_img, human_warning);
+  }
+  return final_img;
+}
+
 /**
  * @brief Detection on the given input type of source
  *
@@ -263,7 +547,7 @@ cv::Mat HumanDetector::rmOverlap(cv::Mat &input_frame, cv::Size &img,
  */
 void HumanDetector::detect(std::string &input_source, bool is_test_mode = false) {
     cv::VideoCapture cap(input_source);
-    cv::Mat frame, blob_img;
+    cv::Mat frame;
     bool is_img = false;
 
     if (input_source.find("dev/video0") != std::string::npos) {
@@ -287,69 +571,24 @@ void HumanDetector::detect(std::string &input_source, bool is_test_mode = false)
         cap.set(cv::CAP_PROP_FRAME_WIDTH, 640);
     }
 
-    // Declare class_path and model_path outside of the if-else block
-    std::string class_path;
-    std::string model_path;
-
-    // Assign values based on whether we're in test mode or not
-    if (is_test_mode) {
-        class_path = "../../models/coco.names";  // Adjust paths for test mode if necessary
-        model_path = "../../models/yolov5s.onnx";
-    } else {
-        class_path = "./models/coco.names";  // Normal mode paths
-        model_path = "./models/yolov5s.onnx";
-    }
-
-    // Read class names from the file
-    std::ifstream read_input(class_path);
     std::vector<std::string> classes;
-    std::string text;
-    while (read_input >> text) {
-        getline(read_input, text);
-        classes.push_back(text);
-    }
-
-    // Load the YOLO model
-    cv::dnn::Net yolo_model = cv::dnn::readNet(model_path);
+    cv::dnn::Net yolo_model = loadModel(is_test_mode, classes);
 
     HumanDetector input;  // Ensure StreamData is defined and accessible
 
-    while (1) {
+    while (!stopRequested()) {
         if (!is_img) {
             frame = input.ImgProcessor(cap);
         }
 
-        cv::Mat input_img = frame;
-
-        // Prepare the image for the model
-        cv::dnn::blobFromImage(input_img, blob_img, 1 / 255.0,
-                               cv::Size(yolo_width, yolo_height), cv::Scalar(),
-                               true, false);
-
-        // Set the input to the model
-        yolo_model.setInput(blob_img);
-
-        std::vector<cv::Mat> out_imgs;
-        yolo_model.forward(out_imgs, yolo_model.getUnconnectedOutLayersNames());
-
-        cv::Size frame_size = cv::Size(input_img.cols, input_img.rows);
-
-        // Call the method to remove overlaps
-        cv::Mat final_img = rmOverlap(input_img, frame_size, out_imgs, classes);
-
-        // Performance measurement
-        std::vector<double> layer_time;
-        double freq = cv::getTickFrequency() / 1000;
-        double time = yolo_model.getPerfProfile(layer_time) / freq;
-        std::string label = cv::format("Inference time: %.2f ms", time);
-        cv::putText(final_img, label, cv::Point(0, 15), cv::FONT_HERSHEY_SIMPLEX,
-                    0.5, cv::Scalar(0, 0, 255));
+        cv::Mat final_img = processFrame(yolo_model, frame, classes);
 
         // Only display the result if not in test mode
         if (!is_test_mode) {
             cv::imshow("Human Detection", final_img);
             char c = static_cast<char>(cv::waitKey(25));
             if (c == 27 || c == 'q') {  // 'Esc' or 'q' to quit
+                requestStop();
                 break;
             }
         } else {
@@ -361,3 +600,108 @@ void HumanDetector::detect(std::string &input_source, bool is_test_mode = false)
     cap.release();
     cv::destroyAllWindows();
 }
+
+/**
+ * @brief Detection on several cameras sharing one model
+ *
+ * All sources are multiplexed onto a single model and set of frame buffers.
+ * The CameraScheduler decides which camera is served next: cameras with a
+ * human inside the warning distance are served at the hot rate, quiet
+ * cameras at the slow rate, and no camera waits past its starvation limit.
+ * Per-camera latency and SLO statistics are printed when the run ends.
+ *
+ * @param sources Device indices ("0", "/dev/video1") or video paths
+ * @param is_test_mode True to serve each camera once and exit
+ */
+void HumanDetector::detectMulti(std::vector<std::string> &sources,
+                                bool is_test_mode) {
+  std::vector<cv::VideoCapture> caps(sources.size());
+  CameraScheduler scheduler;
+
+  for (std::size_t i = 0; i < sources.size(); i++) {
+    const std::string &src = sources[i];
+    std::size_t digits = src.find_last_not_of("0123456789");
+    bool is_device = src.find("dev/video") != std::string::npos ||
+                     (!src.empty() && digits == std::string::npos);
+    if (is_device) {
+      caps[i].open(std::atoi(src.c_str() + (digits == std::string::npos
+                                                 ? 0
+                                                 : digits + 1)));
+    } else {
+      caps[i].open(src);
+    }
+
+    CameraConfig config;
+    config.source = src;
+    int id = scheduler.addCamera(config);
+    if (!caps[i].isOpened()) {
+      std::cout << "Error opening camera " << src << std::endl;
+      scheduler.disable(id);
+      continue;
+    }
+    caps[i].set(cv::CAP_PROP_FRAME_HEIGHT, 480);
+    caps[i].set(cv::CAP_PROP_FRAME_WIDTH, 640);
+    // Keep only the newest frame so quiet cameras are not served stale ones
+    caps[i].set(cv::CAP_PROP_BUFFERSIZE, 1);
+  }
+
+  std::vector<std::string> classes;
+  cv::dnn::Net yolo_model = loadModel(is_test_mode, classes);
+
+  double freq = cv::getTickFrequency() / 1000;
+  double start_ticks = static_cast<double>(cv::getTickCount());
+  auto now_ms = [&]() { return (cv::getTickCount() - start_ticks) / freq; };
+
+  cv::Mat frame;
+  while (scheduler.enabledCount() > 0 && !stopRequested()) {
+    double now = now_ms();
+    int id = scheduler.pickNext(now);
+    if (id < 0) {
+      // Nothing due yet, wait for the earliest camera
+      int wait = std::max(1, static_cast<int>(scheduler.nextDueIn(now)));
+      if (!is_test_mode) {
+        char c = static_cast<char>(cv::waitKey(wait));
+        if (c == 27 || c == 'q') {  // 'Esc' or 'q' to quit
+          requestStop();
+          break;
+        }
+      } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(wait));
+      }
+      continue;
+    }
+
+    if (!caps[id].read(frame) || frame.empty()) {
+      std::cout << "Camera " << sources[id] << " ended" << std::endl;
+      scheduler.disable(id);
+      continue;
+    }
+
+    cv::Mat final_img = processFrame(yolo_model, frame, classes);
+    scheduler.report(id, now, now_ms(), human_warning);
+
+    if (!is_test_mode) {
+      cv::imshow("Human Detection " + std::to_string(id), final_img);
+      char c = static_cast<char>(cv::waitKey(1));
+      if (c == 27 || c == 'q') {  // 'Esc' or 'q' to quit
+        requestStop();
+        break;
+      }
+    } else {
+      // In test mode, serve every camera once and exit
+      scheduler.disable(id);
+    }
+  }
+
+  for (std::size_t i = 0; i < sources.size(); i++) {
+    const CameraStats &st = scheduler.stats(static_cast<int>(i));
+    double mean = st.frames > 0 ? st.total_latency_ms / st.frames : 0.0;
+    std::cout << "Camera " << sources[i] << ": frames=" << st.frames
+              << " mean_latency=" << cv::format("%.2f", mean)
+              << "ms max_latency=" << cv::format("%.2f", st.max_latency_ms)
+              << "ms slo_misses=" << st.slo_misses
+              << " starved=" << st.starved << std::endl;
+    caps[i].release();
+  }
+  cv::destroyAllWindows();
+}
@@ -0,0 +1,384 @@
+/**
+ * @file label_renderer.cpp
+ * @author Tathya Bhatt (tathyab@umd.edu)
+ * @brief Batched overlay drawing with pre-rasterized glyphs
+ * @version 1.0
+ * @date 2024-11-10
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "../include/label_renderer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+/**
+ * @brief Constructor for the renderer
+ *
+ * Glyphs are rasterized lazily on first use, so construction only measures
+ * the font's line height.
+ *
+ * @param face Hershey font face
+ * @param scale Font scale
+ * @param thickness Stroke thickness
+ * @param line Line type used to rasterize glyphs
+ */
+LabelRenderer::LabelRenderer(int face, double scale, int thickness, int line)
+    : font_face(face),
+      font_scale(scale),
+      font_thickness(thickness),
+      line_type(line),
+      glyphs(kLastChar - kFirstChar + 1) {
+  // Height and baseline depend on the font only, not on the characters
+  cv::Size size = cv::getTextSize(" ", font_face, font_scale, font_thickness,
+                                  &text_baseline);
+  text_height = size.height;
+  pad = font_thickness + 1;
+}
+
+/**
+ * @brief Returns the glyph for a character, rasterizing it on first use
+ *
+ * Hershey advances are fractional, so the advance is measured on a run of
+ * 16 copies of the character and kept in 1/16 pixel units.
+ * Characters outside printable ASCII are drawn as '?'.
+ *
+ * @param c Character
+ * @return const Glyph& Cached glyph
+ */
+const LabelRenderer::Glyph &LabelRenderer::glyph(char c) {
+  int code = static_cast<unsigned char>(c);
+  if (code < kFirstChar || code > kLastChar) {
+    code = '?';
+  }
+  Glyph &g = glyphs[code - kFirstChar];
+  if (g.ready) {
+    return g;
+  }
+
+  const int run = 16;
+  int base = 0;
+  cv::Size run_size =
+      cv::getTextSize(std::string(run, static_cast<char>(code)), font_face,
+                      font_scale, font_thickness, &base);
+  g.advance = std::max(0, run_size.width - font_thickness);
+
+  cv::Size size = cv::getTextSize(std::string(1, static_cast<char>(code)),
+                                  font_face, font_scale, font_thickness,
+                                  &base);
+  g.mask = cv::Mat::zeros(text_height + text_baseline + 2 * pad,
+                          size.width + 2 * pad, CV_8UC1);
+  cv::putText(g.mask, std::string(1, static_cast<char>(code)),
+              cv::Point(pad, pad + text_height), font_face, font_scale,
+              cv::Scalar(255), font_thickness, line_type);
+  g.ready = true;
+  return g;
+}
+
+/**
+ * @brief Size of a label, the cached equivalent of cv::getTextSize
+ * @param text Label text
+ * @param baseline Output depth below the baseline, may be nullptr
+ * @return cv::Size Width and height above the baseline
+ */
+cv::Size LabelRenderer::measure(const std::string &text, int *baseline) {
+  return measure(text.c_str(), baseline);
+}
+
+/**
+ * @brief Size of a label given as a C string
+ *
+ * Lets callers format labels into a stack buffer instead of a std::string.
+ *
+ * @param text Null-terminated label text
+ * @param baseline Output depth below the baseline, may be nullptr
+ * @return cv::Size Width and height above the baseline
+ */
+cv::Size LabelRenderer::measure(const char *text, int *baseline) {
+  // Advances are in 1/16 pixel, see glyph()
+  int run_width = 0;
+  for (const char *c = text; *c != '\0'; c++) {
+    run_width += glyph(*c).advance;
+  }
+  if (baseline != nullptr) {
+    *baseline = text_baseline;
+  }
+  return cv::Size(cvRound(run_width / 16.0 + font_thickness), text_height);
+}
+
+/**
+ * @brief Queues a rectangle
+ * @param top_left Top-left corner
+ * @param bottom_right Bottom-right corner
+ * @param color Rectangle color
+ * @param thickness Border thickness, or cv::FILLED
+ * @param alpha Opacity between 0 and 1
+ * @param layer 0 for the base layer, 1 for the overlay drawn last
+ */
+void LabelRenderer::addRect(cv::Point top_left, cv::Point bottom_right,
+                            const cv::Scalar &color, int thickness,
+                            double alpha, int layer) {
+  DrawOp op;
+  op.a = top_left;
+  op.b = bottom_right;
+  op.color = color;
+  op.thickness = thickness;
+  op.alpha = alpha;
+  ops[std::min(std::max(layer, 0), kLayers - 1)].push_back(op);
+}
+
+/**
+ * @brief Queues a label
+ *
+ * The text is appended to a pooled buffer that keeps its capacity between
+ * frames.
+ *
+ * @param text Label text
+ * @param origin Bottom-left corner of the text, as for cv::putText
+ * @param color Text color
+ * @param alpha Opacity between 0 and 1
+ * @param layer 0 for the base layer, 1 for the overlay drawn last
+ */
+void LabelRenderer::addText(const std::string &text, cv::Point origin,
+                            const cv::Scalar &color, double alpha,
+                            int layer) {
+  addText(text.c_str(), origin, color, alpha, layer);
+}
+
+/**
+ * @brief Queues a label given as a C string
+ * @param text Null-terminated label text
+ * @param origin Bottom-left corner of the text, as for cv::putText
+ * @param color Text color
+ * @param alpha Opacity between 0 and 1
+ * @param layer 0 for the base layer, 1 for the overlay drawn last
+ */
+void LabelRenderer::addText(const char *text, cv::Point origin,
+                            const cv::Scalar &color, double alpha,
+                            int layer) {
+  DrawOp op;
+  op.is_text = true;
+  op.a = origin;
+  op.color = color;
+  op.alpha = alpha;
+  op.text_begin = text_pool.size();
+  op.text_len = std::strlen(text);
+  text_pool.append(text, op.text_len);
+  ops[std::min(std::max(layer, 0), kLayers - 1)].push_back(op);
+}
+
+/**
+ * @brief Composites one text operation onto the frame
+ *
+ * Each glyph mask is used as alpha, scaled by the operation's opacity, and
+ * blended into the frame. Masks are clipped to the frame borders.
+ *
+ * @param frame Frame to draw on, CV_8UC3
+ * @param op Text operation
+ */
+void LabelRenderer::drawText(cv::Mat &frame, const DrawOp &op) {
+  const unsigned char color[3] = {cv::saturate_cast<unsigned char>(op.color[0]),
+                                  cv::saturate_cast<unsigned char>(op.color[1]),
+                                  cv::saturate_cast<unsigned char>(op.color[2])};
+  int opacity = cvRound(std::min(std::max(op.alpha, 0.0), 1.0) * 255);
+  cv::Rect bounds(0, 0, frame.cols, frame.rows);
+
+  // Pen position in 1/16 pixel, matching the stored advances
+  int pen = op.a.x * 16;
+  for (std::size_t i = 0; i < op.text_len; i++) {
+    const Glyph &g = glyph(text_pool[op.text_begin + i]);
+    cv::Point tl(cvRound(pen / 16.0) - pad, op.a.y - text_height - pad);
+    pen += g.advance;
+
+    cv::Rect target = cv::Rect(tl, g.mask.size()) & bounds;
+    if (target.empty()) {
+      continue;
+    }
+    for (int y = 0; y < target.height; y++) {
+      const unsigned char *m =
+          g.mask.ptr<unsigned char>(target.y - tl.y + y) + (target.x - tl.x);
+      unsigned char *d = frame.ptr<unsigned char>(target.y + y) + 3 * target.x;
+      for (int x = 0; x < target.width; x++, d += 3) {
+        int a = m[x] * opacity / 255;
+        if (a == 0) {
+          continue;
+        }
+        if (a == 255) {
+          d[0] = color[0];
+          d[1] = color[1];
+          d[2] = color[2];
+        } else {
+          for (int k = 0; k < 3; k++) {
+            d[k] = static_cast<unsigned char>(d[k] +
+                                              (color[k] - d[k]) * a / 255);
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Fills a clipped area of the frame, blended if translucent
+ * @param frame Frame to draw on, CV_8UC3
+ * @param area Area to fill
+ * @param color Fill color
+ * @param alpha Opacity between 0 and 1
+ */
+void LabelRenderer::fillArea(cv::Mat &frame, cv::Rect area,
+                             const cv::Scalar &color, double alpha) {
+  area &= cv::Rect(0, 0, frame.cols, frame.rows);
+  if (area.empty()) {
+    return;
+  }
+  const unsigned char c[3] = {cv::saturate_cast<unsigned char>(color[0]),
+                              cv::saturate_cast<unsigned char>(color[1]),
+                              cv::saturate_cast<unsigned char>(color[2])};
+  int a = cvRound(std::min(std::max(alpha, 0.0), 1.0) * 255);
+  for (int y = area.y; y < area.y + area.height; y++) {
+    unsigned char *d = frame.ptr<unsigned char>(y) + 3 * area.x;
+    for (int x = 0; x < area.width; x++, d += 3) {
+      for (int k = 0; k < 3; k++) {
+        d[k] = a == 255 ? c[k]
+                        : static_cast<unsigned char>(d[k] +
+                                                     (c[k] - d[k]) * a / 255);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Draws one rectangle operation onto the frame
+ *
+ * Filled rectangles are written straight into the clipped region, blended if
+ * the operation is translucent. Borders are drawn as four filled bands
+ * centered on the edges, like cv::rectangle, without its temporary buffers.
+ * The side bands stop short of the top and bottom bands so that translucent
+ * corners are not blended twice.
+ *
+ * @param frame Frame to draw on, CV_8UC3
+ * @param op Rectangle operation
+ */
+void LabelRenderer::drawRect(cv::Mat &frame, const DrawOp &op) {
+  // cv::rectangle includes the bottom-right corner
+  cv::Point tl(std::min(op.a.x, op.b.x), std::min(op.a.y, op.b.y));
+  cv::Point br(std::max(op.a.x, op.b.x) + 1, std::max(op.a.y, op.b.y) + 1);
+  if (op.thickness < 0) {
+    fillArea(frame, cv::Rect(tl, br), op.color, op.alpha);
+    return;
+  }
+
+  int t = std::max(op.thickness, 1);
+  int half = t / 2;
+  tl -= cv::Point(half, half);
+  br += cv::Point(t - 1 - half, t - 1 - half);
+  int side = std::max(br.y - tl.y - 2 * t, 0);
+  fillArea(frame, cv::Rect(tl.x, tl.y, br.x - tl.x, t), op.color, op.alpha);
+  fillArea(frame, cv::Rect(tl.x, br.y - t, br.x - tl.x, t), op.color,
+           op.alpha);
+  fillArea(frame, cv::Rect(tl.x, tl.y + t, t, side), op.color, op.alpha);
+  fillArea(frame, cv::Rect(br.x - t, tl.y + t, t, side), op.color, op.alpha);
+}
+
+/**
+ * @brief Draws one operation with OpenCV's own drawing, for frames that are
+ * not 8-bit BGR
+ *
+ * Translucent operations are drawn onto a copy of the area they cover, which
+ * is then blended back into the frame.
+ *
+ * @param frame Frame to draw on
+ * @param op Text or rectangle operation
+ */
+void LabelRenderer::drawFallback(cv::Mat &frame, const DrawOp &op) {
+  std::string text;
+  cv::Rect area;
+  if (op.is_text) {
+    text = text_pool.substr(op.text_begin, op.text_len);
+    cv::Size size = measure(text, nullptr);
+    area = cv::Rect(op.a.x - pad, op.a.y - text_height - pad,
+                    size.width + 2 * pad,
+                    text_height + text_baseline + 2 * pad);
+  } else {
+    int margin = std::max(op.thickness, 1);
+    area = cv::Rect(cv::Point(std::min(op.a.x, op.b.x) - margin,
+                              std::min(op.a.y, op.b.y) - margin),
+                    cv::Point(std::max(op.a.x, op.b.x) + margin + 1,
+                              std::max(op.a.y, op.b.y) + margin + 1));
+  }
+
+  double alpha = std::min(std::max(op.alpha, 0.0), 1.0);
+  cv::Mat target = frame;
+  cv::Point offset(0, 0);
+  cv::Mat roi;
+  if (alpha < 1.0) {
+    area &= cv::Rect(0, 0, frame.cols, frame.rows);
+    if (area.empty() || alpha <= 0.0) {
+      return;
+    }
+    roi = frame(area);
+    target = roi.clone();
+    offset = area.tl();
+  }
+
+  if (op.is_text) {
+    cv::putText(target, text, op.a - offset, font_face, font_scale, op.color,
+                font_thickness, line_type);
+  } else {
+    cv::rectangle(target, op.a - offset, op.b - offset, op.color,
+                  op.thickness);
+  }
+  if (alpha < 1.0) {
+    cv::addWeighted(target, alpha, roi, 1.0 - alpha, 0.0, roi);
+  }
+}
+
+/**
+ * @brief Draws every queued operation in order and clears the queue
+ *
+ * The base layer is drawn first and the overlay layer last. Frames that are
+ * not 8-bit BGR fall back to OpenCV's own drawing, blended for translucent
+ * operations.
+ *
+ * @param frame Frame to draw on, CV_8UC3
+ */
+void LabelRenderer::render(cv::Mat &frame) {
+  bool fast = frame.type() == CV_8UC3;
+  for (int layer = 0; layer < kLayers; layer++) {
+    for (const DrawOp &op : ops[layer]) {
+      if (!fast) {
+        drawFallback(frame, op);
+      } else if (op.is_text) {
+        drawText(frame, op);
+      } else {
+        drawRect(frame, op);
+      }
+    }
+  }
+  clear();
+}
+
+/**
+ * @brief Drops queued operations without drawing them
+ */
+void LabelRenderer::clear() {
+  for (int layer = 0; layer < kLayers; layer++) {
+    ops[layer].clear();
+  }
+  text_pool.clear();
+}
+
+/**
+ * @brief Number of glyphs rasterized so far
+ * @return std::size_t Glyph count
+ */
+std::size_t LabelRenderer::cachedGlyphs() {
+  std::size_t count = 0;
+  for (const Glyph &g : glyphs) {
+    if (g.ready) {
+      count++;
+    }
+  }
+  return count;
+}
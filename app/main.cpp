@@ -8,22 +8,100 @@
  * @copyright Copyright (c) 2024
  *
  */
+#include <csignal>
+#include <cstdlib>
 #include <iostream>
 #include <ostream>
+#include <string>
+#include <vector>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/opencv.hpp>
 
 #include "human_avoidance.hpp"
 #include "human_detector.hpp"
+#include "frame_recorder.hpp"
+#include "video_segmenter.hpp"
+
+/**
+ * @brief Ends the detection loops on Ctrl+C or kill, so the recording is
+ * finalized and a segmented run exits with an error instead of hanging on
+ * @param signum Signal number
+ */
+void handleStopSignal(int signum) { HumanDetector::requestStop(); }
 
 int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cout << "Usage:\n"
+              << "  " << argv[0] << " <source> [record_prefix] [--events]\n"
+              << "  " << argv[0] << " --multi <source>...\n"
+              << "  " << argv[0]
+              << " --segments <workers> <video> [out.csv] [gop]\n"
+              << "gop is the keyframe interval segments are aligned to, "
+              << "probed from the file when left out" << std::endl;
+    return 1;
+  }
   std::string camera_device = argv[1];
+  bool multi_camera = camera_device == "--multi";
+
+  std::signal(SIGINT, handleStopSignal);
+  std::signal(SIGTERM, handleStopSignal);
 
   HumanDetector detection;
 
-  while (1) {
+  // "--multi src1 src2 ..." runs several cameras on one shared model
+  if (multi_camera) {
+    std::vector<std::string> sources(argv + 2, argv + argc);
+    detection.detectMulti(sources, false);
+    return 0;
+  }
+
+  // "--segments N video [out.csv] [gop]" processes a video file on N
+  // workers, with segment boundaries on multiples of the keyframe interval.
+  // Without gop the interval is probed from the file.
+  if (camera_device == "--segments" && argc > 3) {
+    int gop = argc > 5 ? std::atoi(argv[5])
+                       : VideoSegmentProcessor::probeKeyframeInterval(argv[3]);
+    if (gop <= 0) {
+      std::cout << "Keyframe interval unknown, segments are not aligned"
+                << std::endl;
+    }
+    VideoSegmentProcessor processor(argv[3], std::atoi(argv[2]), gop);
+    if (!processor.run()) {
+      return 1;
+    }
+    if (!processor.writeCsv(argc > 4 ? argv[4]
+                                     : "./results/detections.csv")) {
+      return 1;
+    }
+    return 0;
+  }
+
+  // Optional arguments: a prefix for recording the annotated output, and
+  // "--events" to record only the frames around distance warnings
+  RecorderConfig record_config;
+  // Rotate so a long run never ends up in one huge file
+  record_config.max_segment_seconds = 300.0;
+  record_config.max_segment_bytes = 512u * 1024u * 1024u;
+  bool record = false;
+  for (int i = 2; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--events") {
+      record_config.event_triggered = true;
+    } else {
+      record_config.output_prefix = arg;
+    }
+    record = true;
+  }
+  FrameRecorder recorder(record_config);
+  if (record) {
+    detection.setRecorder(&recorder);
+  }
+
+  while (!HumanDetector::stopRequested()) {
     detection.detect(camera_device, false);
   }
 
+  // Flushes the queued frames and closes the last segment
+  recorder.stop();
   return 0;
 }
@@ -0,0 +1,311 @@
+/**
+ * @file video_segmenter.cpp
+ * @author Tathya Bhatt (tathyab@umd.edu)
+ * @brief Parallel detection over segments of a long video file
+ * @version 1.0
+ * @date 2024-11-09
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "../include/video_segmenter.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#include "../include/human_detector.hpp"
+
+/**
+ * @brief Constructor for the processor
+ * @param path Path to the video file
+ * @param workers Number of parallel workers, 0 to use all cores
+ * @param gop Keyframe interval to align segments to, 0 if unknown
+ * @param is_test_mode True to load the model from the unit test paths
+ */
+VideoSegmentProcessor::VideoSegmentProcessor(const std::string &path,
+                                             int workers, int gop,
+                                             bool is_test_mode)
+    : video_path(path),
+      num_workers(workers),
+      keyframe_interval(gop),
+      test_mode(is_test_mode) {
+  if (num_workers <= 0) {
+    num_workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+}
+
+/**
+ * @brief Splits a video into contiguous segments
+ *
+ * Boundaries are rounded down to a multiple of the keyframe interval so that
+ * each worker's seek lands on a keyframe and no frame is decoded twice.
+ * Segments that round to nothing are dropped.
+ *
+ * @param total_frames Number of frames in the video
+ * @param segments Number of segments wanted
+ * @param gop Keyframe interval to align boundaries to, 0 for none
+ * @return std::vector<std::pair<int, int>> Start and end frame of each
+ * segment, the last segment ends at -1 meaning the end of the stream
+ */
+std::vector<std::pair<int, int>> VideoSegmentProcessor::planSegments(
+    int total_frames, int segments, int gop) {
+  std::vector<std::pair<int, int>> plan;
+  segments = std::max(1, std::min(segments, std::max(1, total_frames)));
+
+  std::vector<int> bounds;
+  bounds.push_back(0);
+  for (int i = 1; i < segments; i++) {
+    int b = static_cast<int>(static_cast<long>(total_frames) * i / segments);
+    if (gop > 1) {
+      b -= b % gop;
+    }
+    if (b > bounds.back()) {
+      bounds.push_back(b);
+    }
+  }
+
+  for (std::size_t i = 0; i < bounds.size(); i++) {
+    int end = (i + 1 < bounds.size()) ? bounds[i + 1] : -1;
+    plan.push_back(std::make_pair(bounds[i], end));
+  }
+  return plan;
+}
+
+/**
+ * @brief Finds the keyframe interval of a video without decoding it
+ *
+ * The FFmpeg backend is switched to raw mode, where grab() reads one packet
+ * without decoding it and CAP_PROP_LRF_HAS_KEY_FRAME tells whether the
+ * packet is a keyframe. The interval is taken from the first two keyframes,
+ * which is exact for the fixed GOP most encoders use. Older OpenCV versions
+ * and other backends do not support this and get 0.
+ *
+ * @param path Path to the video file
+ * @param max_packets Packets to scan before giving up
+ * @return int Frames between the first two keyframes, 0 if unknown
+ */
+int VideoSegmentProcessor::probeKeyframeInterval(const std::string &path,
+                                                 int max_packets) {
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 5)
+  cv::VideoCapture cap(path, cv::CAP_FFMPEG);
+  if (!cap.isOpened() || !cap.set(cv::CAP_PROP_FORMAT, -1)) {
+    return 0;
+  }
+  int first = -1;
+  for (int packet = 0; packet < max_packets && cap.grab(); packet++) {
+    if (cap.get(cv::CAP_PROP_LRF_HAS_KEY_FRAME) == 0) {
+      continue;
+    }
+    if (first >= 0) {
+      return packet - first;
+    }
+    first = packet;
+  }
+#endif
+  return 0;
+}
+
+/**
+ * @brief Processes only the first frames of the video
+ * @param max_frames Number of frames to process, 0 for all
+ */
+void VideoSegmentProcessor::limitFrames(int max_frames) {
+  frame_limit = std::max(0, max_frames);
+}
+
+/**
+ * @brief Positions a capture on a frame, verifying where it landed
+ *
+ * Seeking by frame number is not exact with every backend and container, so
+ * the position is read back. If the seek missed, the capture is reopened and
+ * decoded forward from the start instead.
+ *
+ * @param cap Opened capture
+ * @param frame Frame to position on
+ * @return bool False if the capture could not be positioned
+ */
+bool VideoSegmentProcessor::seekTo(cv::VideoCapture &cap, int frame) {
+  if (frame <= 0) {
+    return true;
+  }
+  cap.set(cv::CAP_PROP_POS_FRAMES, frame);
+  int pos = static_cast<int>(cap.get(cv::CAP_PROP_POS_FRAMES));
+  if (pos == frame) {
+    return true;
+  }
+
+  std::cout << "Seek to frame " << frame << " landed on " << pos
+            << ", decoding forward instead" << std::endl;
+  cap.release();
+  if (!cap.open(video_path)) {
+    return false;
+  }
+  for (int f = 0; f < frame; f++) {
+    if (!cap.grab()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Decodes and processes one segment
+ *
+ * Every worker has its own capture, model and frame arena since neither
+ * VideoCapture nor cv::dnn::Net may be shared between threads. A stop
+ * request ends the segment early and counts as a failure.
+ *
+ * @param start First frame of the segment
+ * @param end One past the last frame, or -1 to read to the end
+ * @param out Detections of the segment, in frame order
+ * @return bool False if the segment could not be processed in full
+ */
+bool VideoSegmentProcessor::processSegment(
+    int start, int end, std::vector<FrameDetections> *out) {
+  cv::VideoCapture cap(video_path);
+  if (!cap.isOpened() || !seekTo(cap, start)) {
+    std::cout << "Error opening video segment at frame " << start
+              << std::endl;
+    return false;
+  }
+
+  HumanDetector detector;
+  std::vector<std::string> classes;
+  cv::dnn::Net yolo_model = detector.loadModel(test_mode, classes);
+  if (yolo_model.empty()) {
+    std::cout << "Error loading model for segment at frame " << start
+              << std::endl;
+    return false;
+  }
+  FrameArena &arena = detector.frameArena();
+
+  cv::Mat frame;
+  int f = start;
+  for (; end < 0 || f < end; f++) {
+    // Ctrl+C or kill, stop at the next frame
+    if (HumanDetector::stopRequested()) {
+      std::cout << "Video segment " << start << " stopped at frame " << f
+                << std::endl;
+      cap.release();
+      return false;
+    }
+    if (!cap.read(frame) || frame.empty()) {
+      break;
+    }
+    detector.processFrame(yolo_model, frame, classes);
+
+    FrameDetections det;
+    det.frame_index = f;
+    det.warning = detector.warningActive();
+    for (int idx : arena.indices) {
+      det.boxes.push_back(arena.boxes[idx]);
+      det.class_ids.push_back(arena.class_ids[idx]);
+      det.confidences.push_back(arena.class_confidences[idx]);
+    }
+    out->push_back(det);
+  }
+  cap.release();
+
+  // Only the last segment may end early, at the end of the stream
+  if (end >= 0 && f < end) {
+    std::cout << "Error, video segment " << start << "-" << end
+              << " ended at frame " << f << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Processes the whole video
+ *
+ * OpenCV's own thread pool is shrunk while the workers run so that the
+ * workers do not oversubscribe the cores.
+ *
+ * @return bool False if the video could not be opened or a segment failed
+ */
+bool VideoSegmentProcessor::run() {
+  cv::VideoCapture probe(video_path);
+  if (!probe.isOpened()) {
+    std::cout << "Error opening input video" << std::endl;
+    return false;
+  }
+  int total_frames = static_cast<int>(probe.get(cv::CAP_PROP_FRAME_COUNT));
+  probe.release();
+  if (frame_limit > 0) {
+    total_frames = total_frames > 0 ? std::min(total_frames, frame_limit)
+                                    : frame_limit;
+  }
+
+  std::vector<std::pair<int, int>> plan =
+      planSegments(total_frames, num_workers, keyframe_interval);
+  if (frame_limit > 0) {
+    plan.back().second = total_frames;
+  }
+  std::vector<std::vector<FrameDetections>> partial(plan.size());
+  std::vector<char> ok(plan.size(), 0);  // Per worker, not vector<bool>
+
+  int cv_threads = cv::getNumThreads();
+  int cores = std::max(1u, std::thread::hardware_concurrency());
+  cv::setNumThreads(std::max(1, cores / static_cast<int>(plan.size())));
+
+  std::vector<std::thread> workers;
+  for (std::size_t i = 0; i < plan.size(); i++) {
+    workers.push_back(std::thread([this, &plan, &partial, &ok, i]() {
+      ok[i] = processSegment(plan[i].first, plan[i].second, &partial[i]);
+    }));
+  }
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+  cv::setNumThreads(cv_threads);
+
+  // Segments are contiguous, so concatenating them keeps frame order
+  results.clear();
+  bool complete = true;
+  for (std::size_t i = 0; i < plan.size(); i++) {
+    if (!ok[i]) {
+      complete = false;
+    }
+    results.insert(results.end(), partial[i].begin(), partial[i].end());
+  }
+  std::cout << "Processed " << results.size() << " frames in " << plan.size()
+            << " segments" << std::endl;
+  if (!complete) {
+    std::cout << "Error, some video segments failed, the results have gaps"
+              << std::endl;
+  }
+  return complete;
+}
+
+/**
+ * @brief Detections of the whole video in frame order
+ * @return const std::vector<FrameDetections>& Per-frame detections
+ */
+const std::vector<FrameDetections> &VideoSegmentProcessor::detections() {
+  return results;
+}
+
+/**
+ * @brief Writes the detections as CSV, one row per box
+ * @param csv_path Output file path
+ * @return bool False if the file could not be written
+ */
+bool VideoSegmentProcessor::writeCsv(const std::string &csv_path) {
+  std::ofstream csv(csv_path);
+  if (!csv.is_open()) {
+    std::cout << "Error opening output file " << csv_path << std::endl;
+    return false;
+  }
+  csv << "frame,x,y,width,height,class_id,confidence,warning\n";
+  for (const FrameDetections &det : results) {
+    for (std::size_t i = 0; i < det.boxes.size(); i++) {
+      const cv::Rect &box = det.boxes[i];
+      csv << det.frame_index << "," << box.x << "," << box.y << ","
+          << box.width << "," << box.height << "," << det.class_ids[i] << ","
+          << det.confidences[i] << "," << det.warning << "\n";
+    }
+  }
+  return true;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file camera_scheduler.hpp
+ * @author Tathya Bhatt (tathyab@umd.edu)
+ * @brief Proximity-aware scheduling of several cameras on one model
+ * @version 1.0
+ * @date 2024-11-08
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Scheduling settings for one camera
+ */
+struct CameraConfig {
+  std::string source;               // Device index or video path
+  double hot_interval_ms = 50.0;    // Frame interval while a human is near
+  double quiet_interval_ms = 400.0;  // Frame interval while nobody is near
+  double hot_hold_ms = 3000.0;      // How long a warning keeps a camera hot
+  double slo_ms = 150.0;            // Allowed delay from due time to result
+  double starvation_ms = 1500.0;    // Longest a camera may go unserved
+};
+
+/**
+ * @brief Per-camera counters kept by the scheduler
+ */
+struct CameraStats {
+  std::size_t frames = 0;      // Frames processed
+  std::size_t slo_misses = 0;  // Frames finished later than the SLO
+  std::size_t starved = 0;     // Frames forced by starvation protection
+  double max_latency_ms = 0.0;  // Worst delay from due time to result
+  double total_latency_ms = 0.0;  // Sum of delays, for the mean
+};
+
+/**
+ * @brief A class deciding which camera the shared model serves next
+ *
+ * Each camera is due once per interval. Cameras where a human was recently
+ * inside the warning distance use the short hot interval and are weighted
+ * ahead of quiet cameras, which drop to the long interval. A camera that has
+ * waited longer than its starvation limit is always served first. A camera
+ * that is late for its SLO deadline, or would be after one more frame, is
+ * served next, earliest deadline first, hot cameras ahead of quiet ones. The
+ * class only does the bookkeeping, the caller owns the captures and the model.
+ */
+class CameraScheduler {
+ private:
+  /**
+   * @brief Scheduling state of one camera
+   */
+  struct Camera {
+    CameraConfig config;
+    CameraStats stats;
+    bool enabled = true;
+    bool served = false;         // False until the first frame
+    double last_served_ms = 0.0;  // Time the last frame was started
+    double last_warning_ms = 0.0;  // Time of the last warning
+    bool warned = false;         // False until the first warning
+    double est_cost_ms = 0.0;    // Smoothed processing time per frame
+  };
+
+  std::vector<Camera> cameras;
+  double hot_weight = 2.0;  // Priority boost for hot cameras
+  double cost_smoothing = 0.2;  // Weight of the newest frame in the cost
+
+  /**
+   * @brief Time at which a camera is next due
+   * @param id Camera id
+   * @param now_ms Current time
+   * @return double Due time in milliseconds
+   */
+  double dueTime(int id, double now_ms) const;
+
+ public:
+  /**
+   * @brief Adds a camera to the schedule
+   * @param config Scheduling settings
+   * @return int Camera id
+   */
+  int addCamera(const CameraConfig &config);
+
+  /**
+   * @brief Removes a camera from scheduling, e.g. when its stream ends
+   * @param id Camera id
+   */
+  void disable(int id);
+
+  /**
+   * @brief Picks the camera to serve next
+   * @param now_ms Current time in milliseconds
+   * @return int Camera id, or -1 if no camera is due
+   */
+  int pickNext(double now_ms) const;
+
+  /**
+   * @brief Time until the next camera becomes due
+   * @param now_ms Current time in milliseconds
+   * @return double Milliseconds to wait, 0 if a camera is due, negative if
+   * no camera is enabled
+   */
+  double nextDueIn(double now_ms) const;
+
+  /**
+   * @brief Records that a camera was served
+   * @param id Camera id
+   * @param start_ms Time the frame was picked
+   * @param end_ms Time the result was ready
+   * @param warning True if a human was inside the warning distance
+   */
+  void report(int id, double start_ms, double end_ms, bool warning);
+
+  /**
+   * @brief Checks whether a camera is in its hot state
+   * @param id Camera id
+   * @param now_ms Current time in milliseconds
+   * @return bool True if a warning was raised within the hold time
+   */
+  bool isHot(int id, double now_ms) const;
+
+  /**
+   * @brief Counters for a camera
+   * @param id Camera id
+   * @return const CameraStats& Camera counters
+   */
+  const CameraStats &stats(int id) const;
+
+  /**
+   * @brief Settings of a camera
+   * @param id Camera id
+   * @return const CameraConfig& Camera settings
+   */
+  const CameraConfig &config(int id) const;
+
+  /**
+   * @brief Number of cameras added
+   * @return std::size_t Camera count
+   */
+  std::size_t size() const;
+
+  /**
+   * @brief Number of cameras still enabled
+   * @return std::size_t Camera count
+   */
+  std::size_t enabledCount() const;
+};
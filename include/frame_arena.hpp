@@ -0,0 +1,124 @@
+/**
+ * @file frame_arena.hpp
+ * @author Tathya Bhatt (tathyab@umd.edu)
+ * @brief Recycled per-frame buffers for the detection loop
+ * @version 1.0
+ * @date 2024-11-06
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Function returning the number of heap allocations made so far
+ */
+typedef std::size_t (*AllocationCounter)();
+
+/**
+ * @brief A class holding every buffer the detection loop needs per frame
+ *
+ * The buffers live for the whole run and are only cleared between frames, so
+ * once the first frame has sized them no further heap allocation is needed.
+ * cv::Mat storage comes from OpenCV's aligned allocator.
+ *
+ * The arena counts the allocations made during each frame. With an
+ * allocation counter installed every heap allocation in the process is
+ * counted, wherever it comes from. Without one the arena can only see its
+ * own buffers being allocated or resized.
+ */
+class FrameArena {
+ private:
+  /**
+   * @brief Address and size of one buffer at frame start
+   */
+  struct BufferState {
+    const void *data;
+    std::size_t bytes;
+  };
+
+  static AllocationCounter counter;     // Process-wide count, or nullptr
+  std::vector<BufferState> snapshot;    // Buffer states at frame start
+  std::size_t start_count = 0;          // Counter value at frame start
+  std::size_t last_allocations = 0;
+  std::size_t total_allocations = 0;
+  std::size_t frame_count = 0;
+
+  /**
+   * @brief Collects the current state of every buffer in the arena
+   * @param states Output list of buffer states
+   */
+  void collect(std::vector<BufferState> &states);
+
+ public:
+  cv::Mat blob_img;                      // Network input blob
+  cv::Size blob_source;                  // Frame size of the resize tables
+  std::vector<int> resize_x;             // Source column per blob column
+  std::vector<float> weight_x;           // Weight of the next source column
+  std::vector<int> resize_y;             // Source row per blob row
+  std::vector<float> weight_y;           // Weight of the next source row
+  std::vector<cv::Mat> out_imgs;         // Network outputs
+  cv::Mat boxed_img;                     // Annotated output frame
+  std::vector<cv::Rect> boxes;           // Candidate boxes
+  std::vector<int> class_ids;            // Candidate class ids
+  std::vector<float> class_confidences;  // Candidate confidences
+  std::vector<int> indices;              // Boxes kept after NMS
+  std::vector<int> order;                // NMS sort scratch
+  std::vector<std::string> out_names;    // Network output layer names
+  std::vector<double> layer_times;       // Per-layer inference times
+
+  /**
+   * @brief Constructor that reserves room for the candidate lists
+   * @param max_candidates Expected maximum number of candidate boxes
+   */
+  explicit FrameArena(std::size_t max_candidates = 25200);
+
+  /**
+   * @brief Installs the source of the process-wide allocation count
+   * @param allocation_counter Counter function, nullptr to count only the
+   * arena's own buffers
+   */
+  static void setAllocationCounter(AllocationCounter allocation_counter);
+
+  /**
+   * @brief Checks whether every heap allocation is counted, or only the
+   * arena's own buffers
+   * @return bool True if an allocation counter is installed
+   */
+  static bool countsAllAllocations();
+
+  /**
+   * @brief Clears the per-frame lists, keeping their memory, and records
+   * the starting point for allocation counting
+   */
+  void beginFrame();
+
+  /**
+   * @brief Counts the allocations made since beginFrame()
+   * @return std::size_t Number of allocations made in this frame
+   */
+  std::size_t endFrame();
+
+  /**
+   * @brief Number of allocations made in the last finished frame
+   * @return std::size_t Allocation count
+   */
+  std::size_t lastFrameAllocations();
+
+  /**
+   * @brief Number of allocations made since the arena was created
+   * @return std::size_t Allocation count
+   */
+  std::size_t totalAllocations();
+
+  /**
+   * @brief Number of frames finished with endFrame()
+   * @return std::size_t Frame count
+   */
+  std::size_t frames();
+};
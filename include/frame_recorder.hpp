@@ -0,0 +1,158 @@
+/**
+ * @file frame_recorder.hpp
+ * @author Tathya Bhatt (tathyab@umd.edu)
+ * @brief Asynchronous recorder for the annotated detection output
+ * @version 1.0
+ * @date 2024-11-05
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Settings for the annotated video recorder
+ */
+struct RecorderConfig {
+  std::string output_prefix = "./results/recording";  // Segment file prefix
+  int fourcc = cv::VideoWriter::fourcc('M', 'J', 'P', 'G');
+  double fps = 20.0;                  // Frame rate written into the file
+  std::size_t pool_size = 64;         // Number of recycled frame buffers
+  std::size_t max_segment_bytes = 0;  // Rotate after this size, 0 = never
+  double max_segment_seconds = 0.0;   // Rotate after this time, 0 = never
+  bool event_triggered = false;       // Only record around warnings
+  std::size_t pre_event_frames = 40;  // Frames kept before a warning
+  std::size_t post_event_frames = 40;  // Frames kept after the last warning
+  double open_retry_seconds = 5.0;    // Wait before retrying a failed open
+};
+
+/**
+ * @brief A class for recording annotated frames off the detection thread
+ *
+ * Frames are copied into a fixed pool of preallocated buffers and handed to a
+ * background thread that owns the cv::VideoWriter. When every buffer is in
+ * use the incoming frame is dropped instead of blocking the caller. Output is
+ * split into segments by size or duration, and in event-triggered mode only
+ * the frames around a distance warning are written.
+ */
+class FrameRecorder {
+ private:
+  RecorderConfig config;
+  cv::Size frame_size;
+  std::vector<cv::Mat> pool;          // Preallocated frame buffers
+  std::deque<std::size_t> free_slots;  // Buffers ready to be filled
+  std::deque<std::size_t> pending;     // Buffers waiting to be encoded
+  std::deque<std::size_t> pre_roll;    // Buffers held before an event
+  std::size_t post_event_left = 0;     // Frames still to keep after an event
+
+  std::mutex mtx;
+  std::condition_variable cv_pending;
+  std::thread writer_thread;
+  bool running = false;
+
+  cv::VideoWriter writer;
+  std::string segment_path;
+  double segment_start_ticks = 0.0;
+  std::size_t segment_frames = 0;
+  bool open_failed = false;           // Last open failed, frames are dropped
+  double retry_ticks = 0.0;           // Earliest time to retry the open
+
+  std::size_t pushed_count = 0;
+  std::size_t dropped_count = 0;
+  std::size_t written_count = 0;
+  std::size_t segment_count = 0;
+
+  /**
+   * @brief Body of the background encoding thread
+   */
+  void writerLoop();
+
+  /**
+   * @brief Opens the next output segment file
+   * @return bool True if the writer could be opened
+   */
+  bool openSegment();
+
+  /**
+   * @brief Checks whether the current segment has reached its size or time
+   * limit
+   * @return bool True if a new segment should be started
+   */
+  bool segmentFull();
+
+  /**
+   * @brief Takes a buffer from the pool, reusing the oldest pre-roll frame
+   * when the pool is empty in event-triggered mode. Caller holds the lock.
+   * @param slot Index of the acquired buffer
+   * @return bool False if no buffer is available
+   */
+  bool acquireSlot(std::size_t &slot);
+
+ public:
+  /**
+   * @brief Constructor for the recorder
+   * @param cfg Recording settings
+   */
+  explicit FrameRecorder(const RecorderConfig &cfg = RecorderConfig());
+
+  /**
+   * @brief Allocates the buffer pool and starts the writer thread
+   * @param size Size of the frames that will be pushed
+   * @return bool True if the recorder started
+   */
+  bool start(const cv::Size &size);
+
+  /**
+   * @brief Queues an annotated frame for writing without blocking
+   * @param frame Annotated frame, must match the size given to start()
+   * @param warning True if a human is inside the warning distance
+   * @return bool False if the frame was dropped
+   */
+  bool push(const cv::Mat &frame, bool warning);
+
+  /**
+   * @brief Flushes queued frames and stops the writer thread
+   */
+  void stop();
+
+  /**
+   * @brief Checks whether the writer thread is running
+   * @return bool True if recording
+   */
+  bool isRunning();
+
+  /**
+   * @brief Number of frames passed to push()
+   * @return std::size_t Frame count
+   */
+  std::size_t pushedFrames();
+
+  /**
+   * @brief Number of frames dropped because the pool was exhausted
+   * @return std::size_t Frame count
+   */
+  std::size_t droppedFrames();
+
+  /**
+   * @brief Number of frames written to disk
+   * @return std::size_t Frame count
+   */
+  std::size_t writtenFrames();
+
+  /**
+   * @brief Number of segment files opened so far
+   * @return std::size_t Segment count
+   */
+  std::size_t segments();
+
+  ~FrameRecorder();
+};
@@ -58,5 +58,20 @@ class HumanAvoidance {
 
   std::vector<float> camera2robot(float z, cv::Rect box, cv::Mat frame);
 
+  /**
+   * @brief Transforms human coordinates into a caller-owned array
+   *
+   * Same as the vector version but without any heap allocation, for the
+   * per-frame detection loop.
+   *
+   * @param z Distance of the human from the camera
+   * @param box Bounding box of the detected human in the camera frame
+   * @param frame The current video frame
+   * @param out Output x, y, z coordinates in the robot's frame
+   */
+
+  void camera2robot(float z, const cv::Rect &box, const cv::Mat &frame,
+                    float out[3]);
+
   ~HumanAvoidance();
 };
\ No newline at end of file
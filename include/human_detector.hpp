@@ -11,6 +11,7 @@
 #pragma once
 
 #include <array>
+#include <csignal>
 #include <iostream>
 #include <opencv2/dnn.hpp>
 #include <opencv2/opencv.hpp>
@@ -20,6 +21,9 @@
 #include <vector>
 
 #include "opencv2/core/mat.hpp"
+#include "frame_arena.hpp"
+#include "frame_recorder.hpp"
+#include "label_renderer.hpp"
 
 /**
  * @brief A class for detecting humans in images or video frames
@@ -39,8 +43,21 @@ class HumanDetector {
   float nmsthresh = 0.4;         // Default NMS threshold
   float confidenceThresh = 0.5;  // Default confidence threshold
   float score_threshold = 0.5;   // Default score threshold
+  float warning_dist = 1.5;      // Distance in meters that raises a warning
   std::string image_path;        // To store the input image path
   cv::Mat frame;                 // To hold the image frame
+  bool human_warning = false;    // Set if the last frame had a warning
+  FrameRecorder *recorder = nullptr;  // Optional recorder for the output
+  FrameArena arena;              // Recycled buffers for the detection loop
+  LabelRenderer renderer;        // Cached glyphs and batched overlay drawing
+  static volatile std::sig_atomic_t stop_requested;  // Set to end the run
+
+  /**
+   * @brief Greedy non-maximum suppression over the arena's candidates
+   *
+   * Fills arena.indices with the kept boxes, highest score first.
+   */
+  void suppressOverlaps();
 
  public:
   HumanDetector();
@@ -61,7 +78,8 @@ class HumanDetector {
   cv::Mat ImgProcessor(cv::VideoCapture &capture_frame);
 
   /**
-   * @brief Draw bounding box around detected human
+   * @brief Draw bounding box around detected human, the label is queued
+   * until renderLabels()
    * @param classid ID of the detected class
    * @param confidence Confidence score of the detection
    * @param left Left coordinate of the bounding box
@@ -76,18 +94,67 @@ class HumanDetector {
                 int bottom, cv::Mat &frame,
                 const std::vector<std::string> &classes, int uniq_id);
 
+  /**
+   * @brief Draw the queued labels onto a frame and clear the queue
+   * @param frame Reference to the frame to draw on
+   */
+  void renderLabels(cv::Mat &frame);
+
   /**
    * @brief Remove overlapping bounding boxes
    * @param input_frame Reference to the input frame
    * @param img Size of the image
    * @param out_imgs Vector of output images
    * @param classes Vector of class names
-   * @return Frame with overlapping boxes removed
+   * @return Frame with overlapping boxes removed, backed by the frame arena
    */
   cv::Mat rmOverlap(cv::Mat &input_frame, cv::Size &img,
                     std::vector<cv::Mat> &out_imgs,
                     std::vector<std::string> &classes);
 
+  /**
+   * @brief Build the network input blob for a frame
+   * @param input_img Frame to process
+   * @return cv::Mat& NCHW blob, backed by the frame arena
+   */
+  cv::Mat &prepareBlob(const cv::Mat &input_img);
+
+  /**
+   * @brief Attach a recorder that receives every annotated frame
+   * @param rec Pointer to the recorder, nullptr to disable recording
+   */
+  void setRecorder(FrameRecorder *rec);
+
+  /**
+   * @brief Access the recycled per-frame buffers
+   * @return FrameArena& Reference to the detector's arena
+   */
+  FrameArena &frameArena();
+
+  /**
+   * @brief Check whether the last processed frame raised a warning
+   * @return bool True if a human was inside the warning distance
+   */
+  bool warningActive();
+
+  /**
+   * @brief Load the class names and the YOLO model
+   * @param is_test_mode True to load from the unit test paths
+   * @param classes Output list of class names
+   * @return cv::dnn::Net Loaded model
+   */
+  cv::dnn::Net loadModel(bool is_test_mode, std::vector<std::string> &classes);
+
+  /**
+   * @brief Run the model on one frame and annotate the result
+   * @param yolo_model Loaded model
+   * @param input_img Frame to process
+   * @param classes List of class names
+   * @return cv::Mat Annotated frame, backed by the frame arena
+   */
+  cv::Mat processFrame(cv::dnn::Net &yolo_model, cv::Mat &input_img,
+                       std::vector<std::string> &classes);
+
   /**
    * @brief Perform human detection on the input source
    * @param input_source Reference to the string containing the input source
@@ -95,5 +162,25 @@ class HumanDetector {
    */
   void detect(std::string &input_source, bool is_test_mode);
 
+  /**
+   * @brief Perform human detection on several cameras sharing one model,
+   * serving cameras with a nearby human more often
+   * @param sources Device indices or video paths
+   * @param is_test_mode True to serve each camera once and exit
+   */
+  void detectMulti(std::vector<std::string> &sources, bool is_test_mode);
+
+  /**
+   * @brief Asks every detection loop to finish, safe to call from a signal
+   * handler
+   */
+  static void requestStop();
+
+  /**
+   * @brief Checks whether the detection loops were asked to finish
+   * @return bool True after requestStop()
+   */
+  static bool stopRequested();
+
   ~HumanDetector();
 };
@@ -0,0 +1,185 @@
+/**
+ * @file label_renderer.hpp
+ * @author Tathya Bhatt (tathyab@umd.edu)
+ * @brief Batched overlay drawing with pre-rasterized glyphs
+ * @version 1.0
+ * @date 2024-11-10
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A class that draws boxes and labels onto a frame in one pass
+ *
+ * Each printable ASCII character is rasterized once with the Hershey font
+ * into an alpha mask. Labels are then composited from the cached masks
+ * instead of being rasterized by cv::putText on every frame. Drawing calls
+ * only queue operations; render() applies the whole frame's queue at once.
+ */
+class LabelRenderer {
+ private:
+  /**
+   * @brief Cached raster of one character
+   */
+  struct Glyph {
+    cv::Mat mask;      // Alpha mask, CV_8UC1
+    int advance = 0;   // Pen advance in 1/16 pixel
+    bool ready = false;
+  };
+
+  /**
+   * @brief One queued drawing operation
+   */
+  struct DrawOp {
+    bool is_text = false;
+    cv::Point a;             // Top-left corner, or text origin
+    cv::Point b;             // Bottom-right corner
+    cv::Scalar color;
+    int thickness = 1;       // cv::FILLED for filled rectangles
+    double alpha = 1.0;      // Opacity of the operation
+    std::size_t text_begin = 0;  // Offset of the text in text_pool
+    std::size_t text_len = 0;
+  };
+
+  static const int kFirstChar = 32;   // ' '
+  static const int kLastChar = 126;   // '~'
+  static const int kLayers = 2;       // Base layer and overlay layer
+
+  int font_face;
+  double font_scale;
+  int font_thickness;
+  int line_type;
+  int text_height = 0;   // Height above the baseline
+  int text_baseline = 0;  // Depth below the baseline
+  int pad = 0;           // Margin around each glyph mask
+
+  std::vector<Glyph> glyphs;
+  std::vector<DrawOp> ops[kLayers];
+  std::string text_pool;  // Text of all queued labels, reused every frame
+
+  /**
+   * @brief Returns the glyph for a character, rasterizing it on first use
+   * @param c Character
+   * @return const Glyph& Cached glyph
+   */
+  const Glyph &glyph(char c);
+
+  /**
+   * @brief Composites one text operation onto the frame
+   * @param frame Frame to draw on, CV_8UC3
+   * @param op Text operation
+   */
+  void drawText(cv::Mat &frame, const DrawOp &op);
+
+  /**
+   * @brief Draws one rectangle operation onto the frame
+   * @param frame Frame to draw on, CV_8UC3
+   * @param op Rectangle operation
+   */
+  void drawRect(cv::Mat &frame, const DrawOp &op);
+
+  /**
+   * @brief Fills a clipped area of the frame, blended if translucent
+   * @param frame Frame to draw on, CV_8UC3
+   * @param area Area to fill
+   * @param color Fill color
+   * @param alpha Opacity between 0 and 1
+   */
+  void fillArea(cv::Mat &frame, cv::Rect area, const cv::Scalar &color,
+                double alpha);
+
+  /**
+   * @brief Draws one operation with OpenCV's own drawing, for frames that
+   * are not 8-bit BGR
+   * @param frame Frame to draw on
+   * @param op Text or rectangle operation
+   */
+  void drawFallback(cv::Mat &frame, const DrawOp &op);
+
+ public:
+  /**
+   * @brief Constructor for the renderer
+   * @param face Hershey font face
+   * @param scale Font scale
+   * @param thickness Stroke thickness
+   * @param line Line type used to rasterize glyphs
+   */
+  explicit LabelRenderer(int face = cv::FONT_HERSHEY_SIMPLEX,
+                         double scale = 0.5, int thickness = 1,
+                         int line = cv::LINE_8);
+
+  /**
+   * @brief Size of a label, the cached equivalent of cv::getTextSize
+   * @param text Label text
+   * @param baseline Output depth below the baseline, may be nullptr
+   * @return cv::Size Width and height above the baseline
+   */
+  cv::Size measure(const std::string &text, int *baseline);
+
+  /**
+   * @brief Size of a label given as a C string
+   * @param text Null-terminated label text
+   * @param baseline Output depth below the baseline, may be nullptr
+   * @return cv::Size Width and height above the baseline
+   */
+  cv::Size measure(const char *text, int *baseline);
+
+  /**
+   * @brief Queues a rectangle
+   * @param top_left Top-left corner
+   * @param bottom_right Bottom-right corner
+   * @param color Rectangle color
+   * @param thickness Border thickness, or cv::FILLED
+   * @param alpha Opacity between 0 and 1
+   * @param layer 0 for the base layer, 1 for the overlay drawn last
+   */
+  void addRect(cv::Point top_left, cv::Point bottom_right,
+               const cv::Scalar &color, int thickness, double alpha = 1.0,
+               int layer = 0);
+
+  /**
+   * @brief Queues a label
+   * @param text Label text
+   * @param origin Bottom-left corner of the text, as for cv::putText
+   * @param color Text color
+   * @param alpha Opacity between 0 and 1
+   * @param layer 0 for the base layer, 1 for the overlay drawn last
+   */
+  void addText(const std::string &text, cv::Point origin,
+               const cv::Scalar &color, double alpha = 1.0, int layer = 0);
+
+  /**
+   * @brief Queues a label given as a C string
+   * @param text Null-terminated label text
+   * @param origin Bottom-left corner of the text, as for cv::putText
+   * @param color Text color
+   * @param alpha Opacity between 0 and 1
+   * @param layer 0 for the base layer, 1 for the overlay drawn last
+   */
+  void addText(const char *text, cv::Point origin, const cv::Scalar &color,
+               double alpha = 1.0, int layer = 0);
+
+  /**
+   * @brief Draws every queued operation in order and clears the queue
+   * @param frame Frame to draw on, CV_8UC3
+   */
+  void render(cv::Mat &frame);
+
+  /**
+   * @brief Drops queued operations without drawing them
+   */
+  void clear();
+
+  /**
+   * @brief Number of glyphs rasterized so far
+   * @return std::size_t Glyph count
+   */
+  std::size_t cachedGlyphs();
+};
@@ -0,0 +1,118 @@
+/**
+ * @file video_segmenter.hpp
+ * @author Tathya Bhatt (tathyab@umd.edu)
+ * @brief Parallel detection over segments of a long video file
+ * @version 1.0
+ * @date 2024-11-09
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Detections kept for one frame of the video
+ */
+struct FrameDetections {
+  int frame_index = 0;
+  std::vector<cv::Rect> boxes;     // Boxes kept after NMS
+  std::vector<int> class_ids;      // Class of each box
+  std::vector<float> confidences;  // Confidence of each box
+  bool warning = false;            // Human inside the warning distance
+};
+
+/**
+ * @brief A class that runs detection on a video file in parallel segments
+ *
+ * The video is split into contiguous frame ranges. Each worker opens its own
+ * VideoCapture, seeks to the start of its range, and runs its own model, so
+ * decode and inference both scale with the number of workers. The results
+ * are merged back in frame order.
+ */
+class VideoSegmentProcessor {
+ private:
+  std::string video_path;
+  int num_workers;
+  int keyframe_interval;  // Segment boundaries are multiples of this
+  bool test_mode;
+  int frame_limit = 0;  // Frames to process from the start, 0 for all
+  std::vector<FrameDetections> results;
+
+  /**
+   * @brief Positions a capture on a frame, verifying where it landed
+   * @param cap Opened capture
+   * @param frame Frame to position on
+   * @return bool False if the capture could not be positioned
+   */
+  bool seekTo(cv::VideoCapture &cap, int frame);
+
+  /**
+   * @brief Decodes and processes one segment
+   * @param start First frame of the segment
+   * @param end One past the last frame, or -1 to read to the end
+   * @param out Detections of the segment, in frame order
+   * @return bool False if the segment could not be processed in full
+   */
+  bool processSegment(int start, int end, std::vector<FrameDetections> *out);
+
+ public:
+  /**
+   * @brief Constructor for the processor
+   * @param path Path to the video file
+   * @param workers Number of parallel workers, 0 to use all cores
+   * @param gop Keyframe interval to align segments to, 0 if unknown
+   * @param is_test_mode True to load the model from the unit test paths
+   */
+  VideoSegmentProcessor(const std::string &path, int workers = 0, int gop = 0,
+                        bool is_test_mode = false);
+
+  /**
+   * @brief Splits a video into contiguous segments
+   * @param total_frames Number of frames in the video
+   * @param segments Number of segments wanted
+   * @param gop Keyframe interval to align boundaries to, 0 for none
+   * @return std::vector<std::pair<int, int>> Start and end frame of each
+   * segment, the last segment ends at -1 meaning the end of the stream
+   */
+  static std::vector<std::pair<int, int>> planSegments(int total_frames,
+                                                       int segments, int gop);
+
+  /**
+   * @brief Finds the keyframe interval of a video without decoding it
+   * @param path Path to the video file
+   * @param max_packets Packets to scan before giving up
+   * @return int Frames between the first two keyframes, 0 if unknown
+   */
+  static int probeKeyframeInterval(const std::string &path,
+                                   int max_packets = 600);
+
+  /**
+   * @brief Processes only the first frames of the video
+   * @param max_frames Number of frames to process, 0 for all
+   */
+  void limitFrames(int max_frames);
+
+  /**
+   * @brief Processes the whole video
+   * @return bool False if the video could not be opened or a segment failed
+   */
+  bool run();
+
+  /**
+   * @brief Detections of the whole video in frame order
+   * @return const std::vector<FrameDetections>& Per-frame detections
+   */
+  const std::vector<FrameDetections> &detections();
+
+  /**
+   * @brief Writes the detections as CSV, one row per box
+   * @param csv_path Output file path
+   * @return bool False if the file could not be written
+   */
+  bool writeCsv(const std::string &csv_path);
+};
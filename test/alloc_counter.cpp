@@ -0,0 +1,79 @@
+/**
+ * @file alloc_counter.cpp
+ * @author Tathya Bhatt (tathyab@umd.edu)
+ * @brief Test-only count of every heap allocation in the process
+ * @version 1.0
+ * @date 2024-11-11
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "alloc_counter.hpp"
+
+#include <atomic>
+#include <cerrno>
+
+// glibc's own allocator, which the replacements below forward to
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *ptr, std::size_t size);
+void *__libc_memalign(std::size_t alignment, std::size_t size);
+void __libc_free(void *ptr);
+}
+
+namespace {
+std::atomic<std::size_t> allocations(0);
+}  // namespace
+
+/**
+ * @brief Number of heap allocations made by the process so far
+ * @return std::size_t Allocation count
+ */
+std::size_t allocationCount() {
+  return allocations.load(std::memory_order_relaxed);
+}
+
+// Replacements for the malloc family. The default operator new calls malloc,
+// so C++ allocations are counted too. free() is not an allocation.
+extern "C" {
+void *malloc(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+
+void *calloc(std::size_t count, std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_realloc(ptr, size);
+}
+
+void *memalign(std::size_t alignment, std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(std::size_t alignment, std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **ptr, std::size_t alignment, std::size_t size) {
+  if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) {
+    return EINVAL;
+  }
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  void *mem = __libc_memalign(alignment, size);
+  if (mem == nullptr) {
+    return ENOMEM;
+  }
+  *ptr = mem;
+  return 0;
+}
+
+void free(void *ptr) { __libc_free(ptr); }
+}
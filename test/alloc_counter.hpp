@@ -0,0 +1,24 @@
+/**
+ * @file alloc_counter.hpp
+ * @author Tathya Bhatt (tathyab@umd.edu)
+ * @brief Test-only count of every heap allocation in the process
+ * @version 1.0
+ * @date 2024-11-11
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief Number of heap allocations made by the process so far
+ *
+ * Linking alloc_counter.cpp replaces the malloc family, so every allocation
+ * is counted: operator new, cv::fastMalloc and C code alike. Pass this to
+ * FrameArena::setAllocationCounter to count real allocations per frame.
+ *
+ * @return std::size_t Allocation count
+ */
+std::size_t allocationCount();
@@ -0,0 +1,216 @@
+/**
+ * @file crowd_stress.cpp
+ * @author Tathya Bhatt (tathyab@umd.edu)
+ * @brief Crowd-density sweep and soak harness for the post-processing path
+ * @version 1.0
+ * @date 2024-11-07
+ *
+ * Usage:
+ *   crowd-stress sweep [iterations]   latency curve over crowd size, overlap,
+ *                                     distractors and confidence spread
+ *   crowd-stress soak [frames]        RSS growth and latency drift
+ *
+ * Results are printed as CSV on stderr, the detector's own logging is muted.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "crowd_synth.hpp"
+#include "human_detector.hpp"
+
+namespace {
+
+/**
+ * @brief Stream buffer that throws away everything written to it
+ */
+class NullBuffer : public std::streambuf {
+ protected:
+  int overflow(int c) override { return c; }
+};
+
+/**
+ * @brief Resident set size of this process
+ * @return double RSS in megabytes
+ */
+double residentMB() {
+  std::ifstream statm("/proc/self/statm");
+  long pages_total = 0;
+  long pages_resident = 0;
+  statm >> pages_total >> pages_resident;
+  return pages_resident * static_cast<double>(sysconf(_SC_PAGESIZE)) /
+         (1024.0 * 1024.0);
+}
+
+/**
+ * @brief Runs rmOverlap once on a synthesized scene
+ * @param detector Detector under test
+ * @param frame Synthesized frame
+ * @param out_imgs Synthesized network output
+ * @param classes Class names
+ * @return double Latency in milliseconds
+ */
+double timeFrame(HumanDetector &detector, cv::Mat &frame,
+                 std::vector<cv::Mat> &out_imgs,
+                 std::vector<std::string> &classes) {
+  cv::Size frame_size(frame.cols, frame.rows);
+  int64_t start = cv::getTickCount();
+  detector.rmOverlap(frame, frame_size, out_imgs, classes);
+  return (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+}
+
+/**
+ * @brief Percentile of a list of samples
+ * @param samples Samples, sorted in place
+ * @param p Percentile between 0 and 1
+ * @return double Sample at the percentile
+ */
+double percentile(std::vector<double> &samples, double p) {
+  if (samples.empty()) {
+    return 0.0;
+  }
+  std::sort(samples.begin(), samples.end());
+  size_t idx = static_cast<size_t>(p * (samples.size() - 1));
+  return samples[idx];
+}
+
+/**
+ * @brief Latency curve over crowd size, overlap, distractors and confidence
+ * distribution
+ * @param iterations Frames measured per configuration
+ */
+void runSweep(int iterations) {
+  const std::vector<int> crowd = {0, 1, 5, 10, 25, 50, 100, 200};
+  const std::vector<float> overlaps = {0.0f, 0.3f, 0.6f};
+  const std::vector<int> distractor_counts = {0, 10, 50};
+  // Confident detections, and a low, wide spread around the thresholds
+  const std::vector<std::pair<float, float>> confidences = {{0.85f, 0.05f},
+                                                            {0.6f, 0.15f}};
+
+  CrowdSynthesizer synth;
+  HumanDetector detector;
+  std::vector<std::string> classes = CrowdSynthesizer::classNames(80);
+  std::vector<cv::Mat> out_imgs(1);
+  NullBuffer null_buffer;
+
+  std::cerr << "people,overlap,distractors,conf_mean,conf_stddev,kept,"
+            << "mean_ms,p50_ms,p99_ms" << std::endl;
+  for (const std::pair<float, float> &conf : confidences) {
+    for (int distractors : distractor_counts) {
+      for (float overlap : overlaps) {
+        for (int people : crowd) {
+          CrowdConfig config;
+          config.people = people;
+          config.overlap = overlap;
+          config.distractors = distractors;
+          config.conf_mean = conf.first;
+          config.conf_stddev = conf.second;
+          synth.synthesize(config, out_imgs[0]);
+          cv::Mat frame = synth.synthesizeFrame(config);
+
+          // rmOverlap logs every box, keep that out of the measurement
+          std::streambuf *old_buffer = std::cout.rdbuf(&null_buffer);
+          std::vector<double> samples;
+          double total = 0.0;
+          for (int i = 0; i < iterations; i++) {
+            double ms = timeFrame(detector, frame, out_imgs, classes);
+            samples.push_back(ms);
+            total += ms;
+          }
+          std::cout.rdbuf(old_buffer);
+
+          size_t kept = detector.frameArena().indices.size();
+          double mean = total / std::max(1, iterations);
+          double p50 = percentile(samples, 0.5);
+          double p99 = percentile(samples, 0.99);
+          std::cerr << people << "," << overlap << "," << distractors << ","
+                    << conf.first << "," << conf.second << "," << kept << ","
+                    << cv::format("%.3f,%.3f,%.3f", mean, p50, p99)
+                    << std::endl;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Long run over random scenes tracking memory and latency drift
+ * @param frames Number of frames to process
+ */
+void runSoak(long frames) {
+  const long window = 10000;
+  CrowdSynthesizer synth;
+  HumanDetector detector;
+  std::vector<std::string> classes = CrowdSynthesizer::classNames(80);
+  NullBuffer null_buffer;
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> people_dist(0, 200);
+  std::uniform_real_distribution<float> overlap_dist(0.0f, 0.6f);
+
+  // A fixed set of scenes, so drift comes from the code and not the input
+  const int num_scenes = 16;
+  std::vector<std::vector<cv::Mat>> scenes(num_scenes,
+                                           std::vector<cv::Mat>(1));
+  std::vector<cv::Mat> scene_frames;
+  for (int i = 0; i < num_scenes; i++) {
+    CrowdConfig config;
+    config.people = people_dist(rng);
+    config.overlap = overlap_dist(rng);
+    config.seed = static_cast<unsigned int>(i);
+    synth.synthesize(config, scenes[i][0]);
+    scene_frames.push_back(synth.synthesizeFrame(config));
+  }
+
+  double start_rss = residentMB();
+  double first_window_ms = 0.0;
+  double window_total = 0.0;
+  std::cerr << "frame,window_mean_ms,drift_pct,rss_mb,rss_growth_mb"
+            << std::endl;
+  std::streambuf *old_buffer = std::cout.rdbuf(&null_buffer);
+  for (long f = 1; f <= frames; f++) {
+    int s = static_cast<int>(f % num_scenes);
+    window_total += timeFrame(detector, scene_frames[s], scenes[s], classes);
+    if (f % window == 0 || f == frames) {
+      long count = (f % window == 0) ? window : f % window;
+      double mean = window_total / count;
+      if (first_window_ms == 0.0) {
+        first_window_ms = mean;
+      }
+      double drift = (mean - first_window_ms) / first_window_ms * 100.0;
+      double rss = residentMB();
+      std::cerr << f << "," << cv::format("%.3f,%.1f,%.1f,%.1f", mean, drift,
+                                          rss, rss - start_rss)
+                << std::endl;
+      window_total = 0.0;
+    }
+  }
+  std::cout.rdbuf(old_buffer);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::string mode = argc > 1 ? argv[1] : "sweep";
+  if (mode == "sweep") {
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 50;
+    runSweep(iterations);
+  } else if (mode == "soak") {
+    long frames = argc > 2 ? std::atol(argv[2]) : 1000000;
+    runSoak(frames);
+  } else {
+    std::cerr << "Usage: " << argv[0] << " [sweep|soak] [count]" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file crowd_synth.cpp
+ * @author Tathya Bhatt (tathyab@umd.edu)
+ * @brief Synthetic YOLO outputs and frames for crowd-density testing
+ * @version 1.0
+ * @date 2024-11-07
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "crowd_synth.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const int kModelSize = 640;  // YOLO input width and height
+const int kGap = 4;          // Pixels between people when overlap is 0
+}  // namespace
+
+/**
+ * @brief Constructor for the synthesizer
+ * @param seed Random seed
+ */
+CrowdSynthesizer::CrowdSynthesizer(unsigned int seed) : rng(seed) {}
+
+/**
+ * @brief Writes one detection row
+ *
+ * The class score is written in the object's own class column and every
+ * other class column is zero.
+ *
+ * @param row Pointer to the start of the row
+ * @param box Box in model space
+ * @param objectness Objectness score of the row
+ * @param class_id Class of the object
+ * @param num_classes Number of class columns
+ */
+void CrowdSynthesizer::writeRow(float *row, const cv::Rect &box,
+                                float objectness, int class_id,
+                                int num_classes) {
+  row[0] = box.x + box.width * 0.5f;
+  row[1] = box.y + box.height * 0.5f;
+  row[2] = static_cast<float>(box.width);
+  row[3] = static_cast<float>(box.height);
+  row[4] = objectness;
+  std::fill(row + 5, row + 5 + num_classes, 0.0f);
+  row[5 + class_id] = objectness;
+}
+
+/**
+ * @brief Builds the YOLO output tensor for a scene
+ *
+ * Box size shrinks with the number of people so that the crowd fits the
+ * frame, the way a real crowd gets smaller with distance.
+ *
+ * @param config Scene settings
+ * @param tensor Output tensor, reused if it already has the right size
+ */
+void CrowdSynthesizer::synthesize(const CrowdConfig &config,
+                                  cv::Mat &tensor) {
+  rng.seed(config.seed);
+  int dims = 5 + config.num_classes;
+  tensor.create(config.rows, dims, CV_32FC1);
+
+  std::normal_distribution<float> conf_dist(config.conf_mean,
+                                            config.conf_stddev);
+  std::uniform_int_distribution<int> jitter(-1, 1);
+  std::uniform_real_distribution<float> background(0.0f, 0.3f);
+  std::uniform_int_distribution<int> other_class(
+      1, std::max(1, config.num_classes - 1));
+
+  // Size people so that the whole crowd fits the model space
+  int people = std::max(0, config.people);
+  float overlap = std::min(std::max(config.overlap, 0.0f), 0.95f);
+  int w = 120;
+  if (people > 0) {
+    double cell = std::sqrt(static_cast<double>(kModelSize) * kModelSize /
+                            (people * 2.2));
+    w = std::min(120, std::max(8, static_cast<int>(cell * 0.8)));
+  }
+  int h = std::min(kModelSize - 1, static_cast<int>(w * 2.2));
+  int step_x = std::max(1, static_cast<int>(w * (1.0f - overlap))) + kGap;
+  int step_y = h + kGap;
+  int cols = std::max(1, (kModelSize - w) / step_x + 1);
+  int grid_rows = std::max(1, (kModelSize - h) / step_y + 1);
+
+  people_boxes.clear();
+  for (int i = 0; i < people; i++) {
+    int col = i % cols;
+    int row = (i / cols) % grid_rows;
+    people_boxes.push_back(cv::Rect(col * step_x, row * step_y, w, h));
+  }
+
+  // Distractors of other classes are scattered at random
+  std::uniform_int_distribution<int> pos(0, kModelSize - w);
+  std::vector<cv::Rect> other_boxes;
+  for (int i = 0; i < config.distractors; i++) {
+    other_boxes.push_back(cv::Rect(pos(rng), pos(rng) % (kModelSize - h), w,
+                                   w));
+  }
+
+  int r = 0;
+  float *data = tensor.ptr<float>(0);
+  auto emit = [&](const cv::Rect &box, int class_id) {
+    for (int d = 0; d < config.duplicates && r < config.rows; d++, r++) {
+      cv::Rect jittered(box.x + jitter(rng), box.y + jitter(rng), box.width,
+                        box.height);
+      float conf = std::min(1.0f, std::max(0.0f, conf_dist(rng)));
+      writeRow(data + r * dims, jittered, conf, class_id,
+               config.num_classes);
+    }
+  };
+  for (const cv::Rect &box : people_boxes) {
+    emit(box, 0);
+  }
+  for (const cv::Rect &box : other_boxes) {
+    emit(box, other_class(rng));
+  }
+
+  // Remaining rows are background anchors below the confidence threshold
+  for (; r < config.rows; r++) {
+    cv::Rect box(pos(rng), pos(rng) % (kModelSize - h), w, h);
+    writeRow(data + r * dims, box, background(rng), 0, config.num_classes);
+  }
+}
+
+/**
+ * @brief Draws a frame that matches the last synthesized scene
+ * @param config Scene settings
+ * @return cv::Mat Frame with a filled box for each person
+ */
+cv::Mat CrowdSynthesizer::synthesizeFrame(const CrowdConfig &config) {
+  cv::Mat frame(config.frame_size, CV_8UC3, cv::Scalar(90, 90, 90));
+  float x_factor = static_cast<float>(config.frame_size.width) / kModelSize;
+  float y_factor = static_cast<float>(config.frame_size.height) / kModelSize;
+  for (const cv::Rect &box : people_boxes) {
+    cv::Point tl(static_cast<int>(box.x * x_factor),
+                 static_cast<int>(box.y * y_factor));
+    cv::Point br(static_cast<int>((box.x + box.width) * x_factor),
+                 static_cast<int>((box.y + box.height) * y_factor));
+    cv::rectangle(frame, tl, br, cv::Scalar(60, 120, 200), cv::FILLED);
+  }
+  return frame;
+}
+
+/**
+ * @brief Person boxes of the last synthesized scene, in model space
+ * @return const std::vector<cv::Rect>& Ground truth boxes
+ */
+const std::vector<cv::Rect> &CrowdSynthesizer::groundTruth() {
+  return people_boxes;
+}
+
+/**
+ * @brief Class names matching the synthesized tensor, "person" first
+ * @param num_classes Number of classes
+ * @return std::vector<std::string> Class names
+ */
+std::vector<std::string> CrowdSynthesizer::classNames(int num_classes) {
+  std::vector<std::string> names = {"person"};
+  for (int i = 1; i < num_classes; i++) {
+    names.push_back("class" + std::to_string(i));
+  }
+  return names;
+}
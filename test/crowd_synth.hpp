@@ -0,0 +1,91 @@
+/**
+ * @file crowd_synth.hpp
+ * @author Tathya Bhatt (tathyab@umd.edu)
+ * @brief Synthetic YOLO outputs and frames for crowd-density testing
+ * @version 1.0
+ * @date 2024-11-07
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Settings for one synthetic crowd scene
+ */
+struct CrowdConfig {
+  int people = 10;              // Number of people in the scene
+  float overlap = 0.0f;         // Horizontal overlap between neighbours, 0-1
+  float conf_mean = 0.85f;      // Mean confidence of a person detection
+  float conf_stddev = 0.05f;    // Spread of the person confidences
+  int duplicates = 3;           // Rows the network emits per object
+  int distractors = 0;          // Objects of other classes in the scene
+  int rows = 25200;             // Rows in the YOLO output
+  int num_classes = 80;         // Classes in the YOLO output
+  unsigned int seed = 42;       // Random seed for repeatable scenes
+  cv::Size frame_size = cv::Size(640, 480);  // Size of the synthetic frame
+};
+
+/**
+ * @brief A class that builds YOLO output tensors and frames for crowd scenes
+ *
+ * People are laid out on a grid in the 640x640 model space with a
+ * controllable overlap between neighbours. Each object is emitted several
+ * times with a small jitter the way YOLO anchors are, and the rest of the
+ * rows are low-confidence background.
+ */
+class CrowdSynthesizer {
+ private:
+  std::mt19937 rng;
+  std::vector<cv::Rect> people_boxes;  // Person boxes of the last scene
+
+  /**
+   * @brief Writes one detection row
+   * @param row Pointer to the start of the row
+   * @param box Box in model space
+   * @param objectness Objectness score of the row
+   * @param class_id Class of the object
+   * @param num_classes Number of class columns
+   */
+  void writeRow(float *row, const cv::Rect &box, float objectness,
+                int class_id, int num_classes);
+
+ public:
+  /**
+   * @brief Constructor for the synthesizer
+   * @param seed Random seed
+   */
+  explicit CrowdSynthesizer(unsigned int seed = 42);
+
+  /**
+   * @brief Builds the YOLO output tensor for a scene
+   * @param config Scene settings
+   * @param tensor Output tensor, reused if it already has the right size
+   */
+  void synthesize(const CrowdConfig &config, cv::Mat &tensor);
+
+  /**
+   * @brief Draws a frame that matches the last synthesized scene
+   * @param config Scene settings
+   * @return cv::Mat Frame with a filled box for each person
+   */
+  cv::Mat synthesizeFrame(const CrowdConfig &config);
+
+  /**
+   * @brief Person boxes of the last synthesized scene, in model space
+   * @return const std::vector<cv::Rect>& Ground truth boxes
+   */
+  const std::vector<cv::Rect> &groundTruth();
+
+  /**
+   * @brief Class names matching the synthesized tensor, "person" first
+   * @param num_classes Number of classes
+   * @return std::vector<std::string> Class names
+   */
+  static std::vector<std::string> classNames(int num_classes);
+};
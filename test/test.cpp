@@ -11,13 +11,20 @@
 
 #include <gtest/gtest.h>
 #include <opencv2/opencv.hpp>
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <string>
 #include <vector>
 
+#include "alloc_counter.hpp"
+#include "camera_scheduler.hpp"
+#include "crowd_synth.hpp"
+#include "frame_recorder.hpp"
 #include "human_avoidance.hpp"
 #include "human_detector.hpp"
+#include "label_renderer.hpp"
+#include "video_segmenter.hpp"
 
 /**
  * @brief Test fixture for the HumanAvoidance class.
@@ -111,6 +118,27 @@ TEST_F(HumanDetectorTest, DrawBboxTest) {
     EXPECT_NO_FATAL_FAILURE(detector.drawBbox(0, 0.9f, 100, 100, 200, 200, frame, classes, 1));
 }
 
+/**
+ * @brief Tests that drawBbox queues its label instead of flushing the queue,
+ * so overlay text queued for another frame stays queued.
+ */
+TEST_F(HumanDetectorTest, DrawBboxQueuesLabelTest) {
+    cv::Mat frame(480, 640, CV_8UC3, cv::Scalar(0, 0, 0));
+    std::vector<std::string> classes = {"person"};
+    detector.drawBbox(0, 0.9f, 100, 100, 200, 200, frame, classes, 1);
+
+    // The box is drawn, the label background above it is not yet
+    cv::Rect label_area(101, 90, 50, 8);
+    std::vector<cv::Mat> channels;
+    cv::split(frame, channels);
+    EXPECT_GT(cv::countNonZero(channels[1]), 0);
+    EXPECT_EQ(cv::countNonZero(channels[1](label_area)), 0);
+
+    detector.renderLabels(frame);
+    cv::split(frame, channels);
+    EXPECT_GT(cv::countNonZero(channels[1](label_area)), 0);
+}
+
 /**
  * @brief Tests the rmOverlap method of HumanDetector with dummy YOLO output.
  */
@@ -125,6 +153,191 @@ TEST_F(HumanDetectorTest, RmOverlapTest) {
     ASSERT_FALSE(result_frame.empty());
 }
 
+/**
+ * @brief Installs the test allocation counter in the frame arena for one
+ * scope, so a failed assertion cannot leave it installed for later tests.
+ */
+class ScopedAllocationCounter {
+public:
+    ScopedAllocationCounter() {
+        FrameArena::setAllocationCounter(&allocationCount);
+    }
+    ~ScopedAllocationCounter() { FrameArena::setAllocationCounter(nullptr); }
+};
+
+/**
+ * @brief Tests that rmOverlap makes no heap allocations once warmed up.
+ */
+TEST_F(HumanDetectorTest, RmOverlapSteadyStateAllocationTest) {
+    cv::Mat input_frame(480, 640, CV_8UC3, cv::Scalar(0, 0, 0));
+    cv::Size img_size(640, 480);
+    std::vector<cv::Mat> out_imgs;
+    out_imgs.push_back(createDummyYOLOOutput(25200, 85));
+    std::vector<std::string> classes = {"person"};
+    FrameArena &arena = detector.frameArena();
+    ScopedAllocationCounter counting;
+
+    // The first frame sizes the output image and rasterizes the glyphs
+    arena.beginFrame();
+    detector.rmOverlap(input_frame, img_size, out_imgs, classes);
+    EXPECT_GT(arena.endFrame(), 0u);
+
+    for (int i = 0; i < 5; ++i) {
+        arena.beginFrame();
+        cv::Mat result = detector.rmOverlap(input_frame, img_size, out_imgs,
+                                            classes);
+        std::size_t allocations = arena.endFrame();
+        ASSERT_FALSE(result.empty());
+        EXPECT_EQ(allocations, 0u);
+    }
+    EXPECT_EQ(arena.frames(), 6u);
+}
+
+/**
+ * @brief Tests that the arena-backed blob matches cv::dnn::blobFromImage.
+ */
+TEST_F(HumanDetectorTest, PrepareBlobTest) {
+    cv::Mat frame(480, 640, CV_8UC3);
+    cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(255));
+    cv::Mat expected = cv::dnn::blobFromImage(
+        frame, 1 / 255.0, cv::Size(640, 640), cv::Scalar(), true, false);
+
+    cv::Mat &blob = detector.prepareBlob(frame);
+    ASSERT_EQ(blob.dims, 4);
+    ASSERT_EQ(blob.total(), expected.total());
+    ASSERT_EQ(blob.type(), expected.type());
+    // Within rounding of OpenCV's fixed-point resize
+    EXPECT_LT(cv::norm(blob, expected, cv::NORM_INF), 2.0 / 255.0);
+}
+
+/**
+ * @brief Tests that blob preparation and post-processing together make no
+ * heap allocations once warmed up.
+ */
+TEST_F(HumanDetectorTest, FrameSteadyStateAllocationTest) {
+    cv::Mat frame(480, 640, CV_8UC3);
+    cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(255));
+    cv::Size img_size(640, 480);
+    std::vector<cv::Mat> out_imgs;
+    out_imgs.push_back(createDummyYOLOOutput(25200, 85));
+    std::vector<std::string> classes = {"person"};
+    FrameArena &arena = detector.frameArena();
+    ScopedAllocationCounter counting;
+
+    // The first frame sizes the blob, the resize tables and the output image
+    arena.beginFrame();
+    detector.prepareBlob(frame);
+    detector.rmOverlap(frame, img_size, out_imgs, classes);
+    EXPECT_GT(arena.endFrame(), 0u);
+
+    for (int i = 0; i < 5; ++i) {
+        arena.beginFrame();
+        cv::Mat &blob = detector.prepareBlob(frame);
+        cv::Mat result = detector.rmOverlap(frame, img_size, out_imgs,
+                                            classes);
+        std::size_t allocations = arena.endFrame();
+        EXPECT_FALSE(blob.empty());
+        EXPECT_FALSE(result.empty());
+        EXPECT_EQ(allocations, 0u);
+    }
+}
+
+/**
+ * @brief Tests that allocations outside the arena's buffers are counted.
+ */
+TEST(FrameArenaTest, CountsEveryAllocationTest) {
+    FrameArena arena;
+    ScopedAllocationCounter counting;
+
+    arena.beginFrame();
+    std::vector<int> scratch(64, 1);
+    EXPECT_EQ(arena.endFrame(), 1u);
+
+    // A buffer freed and allocated again is counted even at the same address
+    arena.beginFrame();
+    scratch = std::vector<int>();
+    scratch.resize(64);
+    EXPECT_EQ(arena.endFrame(), 1u);
+    EXPECT_EQ(arena.totalAllocations(), 2u);
+}
+
+/**
+ * @brief Tests that every person in a synthetic crowd survives NMS exactly
+ * once and that distractors of other classes are dropped.
+ */
+TEST_F(HumanDetectorTest, SyntheticCrowdTest) {
+    CrowdSynthesizer synth;
+    CrowdConfig config;
+    config.people = 25;
+    config.distractors = 10;
+    config.conf_stddev = 0.0f;
+    std::vector<cv::Mat> out_imgs(1);
+    synth.synthesize(config, out_imgs[0]);
+    cv::Mat frame = synth.synthesizeFrame(config);
+    cv::Size img_size(frame.cols, frame.rows);
+    std::vector<std::string> classes = CrowdSynthesizer::classNames(80);
+
+    ASSERT_EQ(out_imgs[0].rows, 25200);
+    ASSERT_EQ(out_imgs[0].cols, 85);
+    detector.rmOverlap(frame, img_size, out_imgs, classes);
+    const FrameArena &arena = detector.frameArena();
+
+    // Ground truth is in the 640x640 model space, scale it to the frame
+    double x_factor = frame.cols / 640.0;
+    double y_factor = frame.rows / 640.0;
+    const std::vector<cv::Rect> &truth = synth.groundTruth();
+    ASSERT_EQ(truth.size(), 25u);
+    EXPECT_EQ(arena.indices.size(), truth.size());
+    for (const cv::Rect &person : truth) {
+        cv::Rect expected(cvRound(person.x * x_factor),
+                          cvRound(person.y * y_factor),
+                          cvRound(person.width * x_factor),
+                          cvRound(person.height * y_factor));
+        int matches = 0;
+        for (int idx : arena.indices) {
+            const cv::Rect &kept = arena.boxes[idx];
+            double inter = (kept & expected).area();
+            double iou = inter / (kept.area() + expected.area() - inter);
+            if (iou > 0.8) {
+                matches++;
+            }
+        }
+        EXPECT_EQ(matches, 1) << "person at " << person.x << ","
+                              << person.y;
+    }
+}
+
+/**
+ * @brief Tests that a confident non-person row is neither kept nor warned on.
+ */
+TEST_F(HumanDetectorTest, RmOverlapIgnoresNonPersonTest) {
+    cv::Mat input_frame(480, 640, CV_8UC3, cv::Scalar(0, 0, 0));
+    cv::Size img_size(640, 480);
+    std::vector<cv::Mat> out_imgs;
+    out_imgs.push_back(cv::Mat::zeros(25200, 85, CV_32FC1));
+    std::vector<std::string> classes(80, "other");
+    classes[0] = "person";
+
+    // A large, close car (class 2) in the first row
+    float* car = out_imgs[0].ptr<float>(0);
+    car[0] = 320.0f;
+    car[1] = 320.0f;
+    car[2] = 300.0f;
+    car[3] = 600.0f;
+    car[4] = 0.95f;
+    car[5 + 2] = 0.95f;
+
+    detector.rmOverlap(input_frame, img_size, out_imgs, classes);
+    EXPECT_TRUE(detector.frameArena().indices.empty());
+    EXPECT_FALSE(detector.warningActive());
+
+    // The same row as a person is kept and raises the warning
+    car[5] = 0.95f;
+    detector.rmOverlap(input_frame, img_size, out_imgs, classes);
+    EXPECT_EQ(detector.frameArena().indices.size(), 1u);
+    EXPECT_TRUE(detector.warningActive());
+}
+
 /**
  * @brief Tests the detect method with an image input.
  */
@@ -145,3 +358,396 @@ TEST_F(HumanDetectorTest, DetectValidVideoTest) {
     EXPECT_NO_FATAL_FAILURE(detector.detect(test_video_path, true));
     // cap.release();
 }
+
+/**
+ * @brief Tests that every pushed frame is either written or dropped.
+ */
+TEST(FrameRecorderTest, ContinuousRecordingTest) {
+    RecorderConfig config;
+    config.output_prefix = "./recorder_test";
+    config.pool_size = 4;
+    FrameRecorder recorder(config);
+    ASSERT_TRUE(recorder.start(cv::Size(320, 240)));
+
+    cv::Mat frame(240, 320, CV_8UC3, cv::Scalar(0, 255, 0));
+    for (int i = 0; i < 30; ++i) {
+        recorder.push(frame, false);
+    }
+    recorder.stop();
+
+    EXPECT_EQ(recorder.pushedFrames(), 30u);
+    EXPECT_EQ(recorder.writtenFrames() + recorder.droppedFrames(), 30u);
+    EXPECT_EQ(recorder.segments(), 1u);
+}
+
+/**
+ * @brief Tests that event-triggered recording keeps only the frames around
+ * a warning.
+ */
+TEST(FrameRecorderTest, EventTriggeredRecordingTest) {
+    RecorderConfig config;
+    config.output_prefix = "./recorder_event_test";
+    config.event_triggered = true;
+    config.pre_event_frames = 5;
+    config.post_event_frames = 3;
+    FrameRecorder recorder(config);
+    ASSERT_TRUE(recorder.start(cv::Size(320, 240)));
+
+    cv::Mat frame(240, 320, CV_8UC3, cv::Scalar(0, 0, 255));
+    for (int i = 0; i < 20; ++i) {
+        recorder.push(frame, false);
+    }
+    recorder.push(frame, true);
+    for (int i = 0; i < 20; ++i) {
+        recorder.push(frame, false);
+    }
+    recorder.stop();
+
+    // 5 pre-event frames, the warning frame and 3 post-event frames
+    EXPECT_EQ(recorder.droppedFrames(), 0u);
+    EXPECT_EQ(recorder.writtenFrames(), 9u);
+}
+
+/**
+ * @brief Tests that a recording file that cannot be opened is not retried
+ * on every frame.
+ */
+TEST(FrameRecorderTest, OpenFailureBackoffTest) {
+    RecorderConfig config;
+    config.output_prefix = "./missing_recorder_dir/recording";
+    config.pool_size = 4;
+    config.open_retry_seconds = 60.0;
+    FrameRecorder recorder(config);
+    ASSERT_TRUE(recorder.start(cv::Size(320, 240)));
+
+    cv::Mat frame(240, 320, CV_8UC3, cv::Scalar(255, 0, 0));
+    for (int i = 0; i < 30; ++i) {
+        recorder.push(frame, false);
+    }
+    recorder.stop();
+
+    EXPECT_EQ(recorder.writtenFrames(), 0u);
+    EXPECT_EQ(recorder.droppedFrames(), 30u);
+    EXPECT_EQ(recorder.segments(), 0u);
+}
+
+/**
+ * @brief Tests that frames of the wrong size are dropped.
+ */
+TEST(FrameRecorderTest, WrongFrameSizeTest) {
+    RecorderConfig config;
+    config.output_prefix = "./recorder_size_test";
+    FrameRecorder recorder(config);
+    ASSERT_TRUE(recorder.start(cv::Size(320, 240)));
+    cv::Mat frame(480, 640, CV_8UC3, cv::Scalar(0, 0, 0));
+    EXPECT_FALSE(recorder.push(frame, false));
+    recorder.stop();
+    EXPECT_EQ(recorder.droppedFrames(), 1u);
+}
+
+/**
+ * @brief Simulates the shared model serving cameras with a fixed cost per
+ * frame.
+ * @param scheduler Scheduler under test
+ * @param hot_cameras Cameras that always report a warning
+ * @param duration_ms Simulated run time
+ * @param cost_ms Simulated processing time per frame
+ */
+void simulateSchedule(CameraScheduler &scheduler,
+                      const std::vector<int> &hot_cameras,
+                      double duration_ms, double cost_ms) {
+    double now = 0.0;
+    while (now < duration_ms) {
+        int id = scheduler.pickNext(now);
+        if (id < 0) {
+            now += std::max(1.0, scheduler.nextDueIn(now));
+            continue;
+        }
+        bool hot = std::find(hot_cameras.begin(), hot_cameras.end(), id) !=
+                   hot_cameras.end();
+        scheduler.report(id, now, now + cost_ms, hot);
+        now += cost_ms;
+    }
+}
+
+/**
+ * @brief Tests that every camera is served before any camera is served twice.
+ */
+TEST(CameraSchedulerTest, ServesEveryCameraFirstTest) {
+    CameraScheduler scheduler;
+    for (int i = 0; i < 4; ++i) {
+        scheduler.addCamera(CameraConfig());
+    }
+    for (int i = 0; i < 4; ++i) {
+        int id = scheduler.pickNext(i * 10.0);
+        ASSERT_GE(id, 0);
+        EXPECT_EQ(scheduler.stats(id).frames, 0u);
+        scheduler.report(id, i * 10.0, i * 10.0 + 10.0, false);
+    }
+    EXPECT_EQ(scheduler.pickNext(40.0), -1);
+    EXPECT_GT(scheduler.nextDueIn(40.0), 0.0);
+}
+
+/**
+ * @brief Tests that a camera with a nearby human gets more frames.
+ */
+TEST(CameraSchedulerTest, HotCameraPriorityTest) {
+    CameraScheduler scheduler;
+    for (int i = 0; i < 6; ++i) {
+        scheduler.addCamera(CameraConfig());
+    }
+    simulateSchedule(scheduler, {2}, 10000.0, 30.0);
+
+    EXPECT_TRUE(scheduler.isHot(2, 10000.0));
+    EXPECT_FALSE(scheduler.isHot(0, 10000.0));
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_EQ(scheduler.stats(i).slo_misses, 0u);
+        if (i != 2) {
+            EXPECT_GT(scheduler.stats(2).frames, 3 * scheduler.stats(i).frames);
+        }
+    }
+}
+
+/**
+ * @brief Tests that quiet cameras meet their SLO while a hot camera
+ * saturates the model.
+ */
+TEST(CameraSchedulerTest, SloDeadlineTest) {
+    CameraScheduler scheduler;
+    CameraConfig config;
+    config.hot_interval_ms = 10.0;
+    for (int i = 0; i < 3; ++i) {
+        scheduler.addCamera(config);
+    }
+    // Frames cost more than the hot interval, so camera 0 is always due
+    simulateSchedule(scheduler, {0}, 20000.0, 40.0);
+
+    // A quiet deadline may slip by one frame when the hot camera is urgent
+    for (int i = 1; i < 3; ++i) {
+        const CameraStats &st = scheduler.stats(i);
+        EXPECT_LE(st.slo_misses, st.frames / 20);
+        EXPECT_EQ(st.starved, 0u);
+        EXPECT_LE(st.max_latency_ms, config.slo_ms + 40.0);
+        EXPECT_GT(scheduler.stats(0).frames, 5 * st.frames);
+    }
+}
+
+/**
+ * @brief Tests that under overload several hot cameras still get lower
+ * latency than the quiet ones.
+ */
+TEST(CameraSchedulerTest, HotCamerasUnderOverloadTest) {
+    CameraScheduler scheduler;
+    for (int i = 0; i < 6; ++i) {
+        scheduler.addCamera(CameraConfig());
+    }
+    // Three hot cameras at 50 ms intervals cannot all be met at 60 ms/frame
+    simulateSchedule(scheduler, {0, 1, 2}, 10000.0, 60.0);
+
+    for (int hot = 0; hot < 3; ++hot) {
+        const CameraStats &h = scheduler.stats(hot);
+        ASSERT_GT(h.frames, 0u);
+        for (int quiet = 3; quiet < 6; ++quiet) {
+            const CameraStats &q = scheduler.stats(quiet);
+            ASSERT_GT(q.frames, 0u);
+            EXPECT_GT(h.frames, q.frames);
+            EXPECT_LE(h.max_latency_ms, q.max_latency_ms);
+            EXPECT_LE(h.total_latency_ms / h.frames,
+                      q.total_latency_ms / q.frames);
+        }
+    }
+}
+
+/**
+ * @brief Tests that quiet cameras keep being served when the model is
+ * saturated by hot cameras.
+ */
+TEST(CameraSchedulerTest, StarvationProtectionTest) {
+    CameraScheduler scheduler;
+    CameraConfig config;
+    config.hot_interval_ms = 10.0;
+    // No deadline pressure, so only starvation protection serves the quiet
+    // cameras
+    config.slo_ms = 1e9;
+    for (int i = 0; i < 3; ++i) {
+        scheduler.addCamera(config);
+    }
+    // Frames cost more than the hot interval, so camera 0 is always due
+    simulateSchedule(scheduler, {0}, 20000.0, 40.0);
+
+    for (int i = 1; i < 3; ++i) {
+        const CameraStats &st = scheduler.stats(i);
+        EXPECT_GE(st.frames, 20000.0 / (config.starvation_ms + 40.0));
+        EXPECT_LE(st.max_latency_ms, config.starvation_ms);
+    }
+}
+
+/**
+ * @brief Tests that segments cover the video contiguously and in order.
+ */
+TEST(VideoSegmentTest, PlanSegmentsTest) {
+    auto plan = VideoSegmentProcessor::planSegments(1000, 4, 0);
+    ASSERT_EQ(plan.size(), 4u);
+    EXPECT_EQ(plan[0].first, 0);
+    for (size_t i = 0; i + 1 < plan.size(); ++i) {
+        EXPECT_EQ(plan[i].second, plan[i + 1].first);
+        EXPECT_LT(plan[i].first, plan[i].second);
+    }
+    EXPECT_EQ(plan.back().second, -1);
+}
+
+/**
+ * @brief Tests that segment boundaries land on keyframes.
+ */
+TEST(VideoSegmentTest, PlanSegmentsKeyframeTest) {
+    auto plan = VideoSegmentProcessor::planSegments(1000, 3, 30);
+    ASSERT_EQ(plan.size(), 3u);
+    for (const auto &segment : plan) {
+        EXPECT_EQ(segment.first % 30, 0);
+    }
+
+    // Short videos and unknown frame counts fall back to fewer segments
+    EXPECT_EQ(VideoSegmentProcessor::planSegments(40, 8, 30).size(), 2u);
+    EXPECT_EQ(VideoSegmentProcessor::planSegments(0, 8, 0).size(), 1u);
+}
+
+/**
+ * @brief Tests that the keyframe probe reports an unknown interval as 0.
+ */
+TEST(VideoSegmentTest, ProbeKeyframeIntervalTest) {
+    EXPECT_EQ(VideoSegmentProcessor::probeKeyframeInterval("missing.mp4"), 0);
+}
+
+/**
+ * @brief Tests that parallel segments give the same frames, in order, as a
+ * single worker.
+ */
+TEST(VideoSegmentTest, ParallelMatchesSerialTest) {
+    std::string test_video_path = "../../input/test_video.mp4";
+    VideoSegmentProcessor serial(test_video_path, 1, 0, true);
+    serial.limitFrames(24);
+    ASSERT_TRUE(serial.run());
+    VideoSegmentProcessor parallel(test_video_path, 3, 0, true);
+    parallel.limitFrames(24);
+    ASSERT_TRUE(parallel.run());
+
+    const std::vector<FrameDetections> &expected = serial.detections();
+    const std::vector<FrameDetections> &actual = parallel.detections();
+    ASSERT_EQ(expected.size(), 24u);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        EXPECT_EQ(expected[i].frame_index, static_cast<int>(i));
+        EXPECT_EQ(actual[i].frame_index, static_cast<int>(i));
+
+        // Same frames through the same model give the same detections
+        EXPECT_EQ(actual[i].warning, expected[i].warning) << "frame " << i;
+        EXPECT_EQ(actual[i].class_ids, expected[i].class_ids) << "frame " << i;
+        ASSERT_EQ(actual[i].boxes.size(), expected[i].boxes.size())
+            << "frame " << i;
+        ASSERT_EQ(actual[i].confidences.size(), expected[i].confidences.size())
+            << "frame " << i;
+        for (size_t b = 0; b < actual[i].boxes.size(); ++b) {
+            EXPECT_EQ(actual[i].boxes[b], expected[i].boxes[b])
+                << "frame " << i << " box " << b;
+            EXPECT_FLOAT_EQ(actual[i].confidences[b],
+                            expected[i].confidences[b])
+                << "frame " << i << " box " << b;
+        }
+    }
+}
+
+/**
+ * @brief Tests that cached label sizes match cv::getTextSize.
+ */
+TEST(LabelRendererTest, MeasureTest) {
+    LabelRenderer renderer;
+    std::string label = "person|0.87 D2H = 1.23 X = -0.51";
+    int base_cv = 0;
+    int base_cached = 0;
+    cv::Size expected = cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX, 0.5,
+                                        1, &base_cv);
+    cv::Size measured = renderer.measure(label, &base_cached);
+    EXPECT_NEAR(measured.width, expected.width, 1);
+    EXPECT_EQ(measured.height, expected.height);
+    EXPECT_EQ(base_cached, base_cv);
+}
+
+/**
+ * @brief Tests that rendered labels cover the same area as cv::putText and
+ * that glyphs are only rasterized once.
+ */
+TEST(LabelRendererTest, RenderTest) {
+    LabelRenderer renderer;
+    std::string label = "D2H = 1.23";
+    cv::Point origin(20, 40);
+    cv::Mat expected(80, 200, CV_8UC3, cv::Scalar(0, 0, 0));
+    cv::putText(expected, label, origin, cv::FONT_HERSHEY_SIMPLEX, 0.5,
+                cv::Scalar(255, 255, 255), 1);
+
+    cv::Mat frame(80, 200, CV_8UC3, cv::Scalar(0, 0, 0));
+    renderer.addRect(cv::Point(150, 60), cv::Point(160, 70),
+                     cv::Scalar(0, 0, 255), cv::FILLED);
+    renderer.addText(label, origin, cv::Scalar(255, 255, 255));
+    renderer.render(frame);
+    size_t glyphs = renderer.cachedGlyphs();
+
+    std::vector<cv::Mat> expected_ch;
+    std::vector<cv::Mat> frame_ch;
+    cv::split(expected, expected_ch);
+    cv::split(frame, frame_ch);
+    int expected_px = cv::countNonZero(expected_ch[0]);
+    int text_px = cv::countNonZero(frame_ch[0]);
+    EXPECT_GT(text_px, 0);
+    EXPECT_NEAR(text_px, expected_px, expected_px * 0.3);
+    EXPECT_EQ(cv::countNonZero(frame_ch[2]) - text_px, 11 * 11);
+
+    // Drawing the same label again reuses the cached glyphs
+    renderer.addText(label, origin, cv::Scalar(255, 255, 255), 0.5);
+    renderer.render(frame);
+    EXPECT_EQ(renderer.cachedGlyphs(), glyphs);
+}
+
+/**
+ * @brief Tests that translucent outlines are blended once everywhere,
+ * corners included.
+ */
+TEST(LabelRendererTest, OutlineAlphaTest) {
+    LabelRenderer renderer;
+    cv::Mat frame(40, 60, CV_8UC3, cv::Scalar(0, 0, 0));
+    renderer.addRect(cv::Point(10, 10), cv::Point(40, 25),
+                     cv::Scalar(0, 0, 200), 3, 0.5);
+    renderer.render(frame);
+
+    int border_px = 0;
+    for (int y = 0; y < frame.rows; y++) {
+        for (int x = 0; x < frame.cols; x++) {
+            int red = frame.at<cv::Vec3b>(y, x)[2];
+            if (red != 0) {
+                EXPECT_EQ(red, 100);
+                border_px++;
+            }
+        }
+    }
+    // Outer 33x18 box minus the 27x12 hole
+    EXPECT_EQ(border_px, 33 * 18 - 27 * 12);
+}
+
+/**
+ * @brief Tests that frames drawn with OpenCV's fallback still honor alpha.
+ */
+TEST(LabelRendererTest, FallbackAlphaTest) {
+    LabelRenderer renderer;
+    cv::Mat frame(40, 60, CV_8UC4, cv::Scalar(0, 0, 0, 0));
+    renderer.addRect(cv::Point(10, 10), cv::Point(20, 20),
+                     cv::Scalar(0, 0, 200, 0), cv::FILLED, 0.5);
+    renderer.addText("A", cv::Point(30, 30), cv::Scalar(0, 200, 0, 0), 0.5);
+    renderer.render(frame);
+
+    EXPECT_EQ(frame.at<cv::Vec4b>(15, 15)[2], 100);
+    EXPECT_EQ(frame.at<cv::Vec4b>(5, 5)[2], 0);
+    double max_green = 0;
+    std::vector<cv::Mat> channels;
+    cv::split(frame, channels);
+    cv::minMaxLoc(channels[1], nullptr, &max_green);
+    EXPECT_EQ(max_green, 100);
+}